@@ -5,7 +5,7 @@
     character followed by any alphanumeric characters or any underscores.
 */
 
-#include "scanner.h"
+#include "token_stream.h"
 
 int main(int argc, char* argv[])
 {
@@ -15,25 +15,32 @@ int main(int argc, char* argv[])
         return 1;
     }
 
-    FILE* in = fopen(argv[1], "r");
+    SourceBuffer buffer;
 
-    if (!in)
+    if (!open_source_buffer(&buffer, argv[1]))
     {
         printf("Could not open %s\n", argv[1]);
         return 1;
     }
 
-    while (TRUE)
-    {
-        Token t = scan_token(in);
+    TokenStream tokens;
 
-        if (t.token == TOKEN_EOF)
-        {
-            break;
-        }
+    if (!scan_all(&buffer, &tokens))
+    {
+        printf("Out of memory\n");
+        close_source_buffer(&buffer);
+        return 1;
+    }
 
-        printf("Token: %s value: %s\n", to_str(t.token), t.value);
+    // The last token is the EOF.
+    for (size_t i = 0; i + 1 < tokens.size; ++i)
+    {
+        printf("Token: %s value: %.*s\n", to_str((token_t)tokens.kinds[i]), (int)tokens.lengths[i],
+            buffer.data + tokens.offsets[i]);
     }
 
+    free_token_stream(&tokens);
+    close_source_buffer(&buffer);
+
     return 0;
 }
\ No newline at end of file
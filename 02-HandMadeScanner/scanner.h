@@ -1,180 +1,148 @@
 #pragma once
 
-#include <ctype.h>
 #include <stdio.h>
+#include <string.h>
 
+#include "char_class.h"
+#include "source_buffer.h"
 #include "token.h"
 
-#ifndef BOOL
-#define BOOL int
-#endif
+/*
+    The scanner walks the source buffer with a raw pointer. The buffer
+    ends with a NUL sentinel that no character class includes, so every
+    loop stops at the end on its own.
+*/
+typedef struct
+{
+    const char* begin;
+    const char* current;
+}
+Scanner;
 
-#ifndef TRUE
-#define TRUE 1
-#endif
+void init_scanner(Scanner* s, const SourceBuffer* buffer)
+{
+    s->begin = buffer->data;
+    s->current = buffer->data;
+}
 
-#ifndef FALSE
-#define FALSE 0
-#endif
+/* Text of a token, which is not NUL-terminated: it is followed by the rest of the input. */
+const char* token_text(const Scanner* s, Token t)
+{
+    return s->begin + t.offset;
+}
 
-void skip_whitespaces(FILE* f)
+/* NUL-terminated copy of the text of a token, to be freed by the caller. */
+char* token_value(const Scanner* s, Token t)
 {
-    int c = fgetc(f);
-    
-    while (isspace(c))
+    char* value = malloc(t.length + 1);
+
+    if (value != NULL)
     {
-        c = fgetc(f);
+        memcpy(value, token_text(s, t), t.length);
+        value[t.length] = '\0';
     }
 
-    ungetc(c, f);
+    return value;
 }
 
-BOOL is_next_equal_char(FILE* f)
+/* Token from begin to the current position. */
+Token scanned_token(const Scanner* s, token_t token, const char* begin)
 {
-    int c = fgetc(f);
+    return make_token(token, (uint32_t)(begin - s->begin), (uint32_t)(s->current - begin));
+}
 
-    if (c == '=')
+void skip_whitespaces(Scanner* s)
+{
+    s->current = skip_spaces(s->current);
+}
+
+BOOL is_next_equal_char(Scanner* s)
+{
+    if (*s->current == '=')
     {
+        ++s->current;
         return TRUE;
     }
 
-    ungetc(c, f);
-
     return FALSE;
 }
 
-Token build_integer_token(FILE* f, char c)
+Token build_integer_token(Scanner* s)
 {
-    int n = 0;
-    Token t;
-    t.token = TOKEN_INTEGER;
-    t.value[n++] = c;
-
-    c = fgetc(f);
+    const char* begin = s->current;
+    s->current = skip_digits(begin + 1);
 
-    while (isdigit(c))
-    {
-        t.value[n++] = c;
-        c = fgetc(f);        
-    }
-
-    t.value[n] = '\0';
-    ungetc(c, f);
-
-    return t;
+    return scanned_token(s, TOKEN_INTEGER, begin);
 }
 
-Token build_identifier_token(FILE* f, char c)
+Token build_identifier_token(Scanner* s)
 {
-    int n = 0;
-    Token t;
-    t.token = TOKEN_IDENTIFIER;
-    t.value[n++] = c;
+    const char* begin = s->current;
+    const char* p = begin + 1;
 
-    c = fgetc(f);
-    
-    if (t.value[0] == '_' && (c == '_' || !isalnum(c)))
+    if (*begin == '_' && (*p == '_' || !is_alnum(*p)))
     {
-        while (c == '_')
+        while (*p == '_')
         {
-            t.value[n++] = c;
-            c = fgetc(f);
+            ++p;
         }
 
-        t.token = TOKEN_UNKNOWN;
-        t.value[n--] = '\0';
-
-        if (isalnum(c))
+        // The last underscore of the run starts the identifier that follows.
+        if (is_alnum(*p))
         {
-            ungetc(c, f);
-            ungetc('_', f);
-            t.value[n--] = '\0';
-        }
-        else
-        {
-            ungetc(c, f);
+            --p;
         }
 
-        return t;
-    }
+        s->current = p;
 
-    while (c == '_' || isalnum(c))
-    {
-        t.value[n++] = c;
-        c = fgetc(f);
+        return scanned_token(s, TOKEN_UNKNOWN, begin);
     }
 
-    t.value[n] = '\0';
-    ungetc(c, f);
+    s->current = skip_identifier_chars(p);
 
-    return t;
+    return scanned_token(s, TOKEN_IDENTIFIER, begin);
 }
 
-Token scan_token(FILE* f)
+Token scan_token(Scanner* s)
 {
-    Token result;
+    skip_whitespaces(s);
 
-    skip_whitespaces(f);
+    const char* begin = s->current;
+    char c = *begin;
 
-    if (feof(f))
+    if (c == '\0')
     {
-        result.value[0] = '\0';
-        result.token = TOKEN_EOF;
-        return result;
+        return scanned_token(s, TOKEN_EOF, begin);
     }
 
-    int c = fgetc(f);
+    if (is_digit(c))
+    {
+        return build_integer_token(s);
+    }
+
+    if (c == '_' || is_alpha(c))
+    {
+        return build_identifier_token(s);
+    }
+
+    ++s->current;
 
     if (c == '*')
     {
-        result.token = TOKEN_MULTIPLY;
-        result.value[0] = '*';
-        result.value[1] = '\0';
-        return result;
+        return scanned_token(s, TOKEN_MULTIPLY, begin);
     }
     
     if (c == '=')
     {
-        result.value[0] = '=';
-        if (is_next_equal_char(f))
-        {
-            result.token = TOKEN_EQUAL;
-            result.value[1] = '=';
-            result.value[2] = '\0';
-            return result;
-        }
-        result.token = TOKEN_ASSIGN;
-        result.value[1] = '\0';
-        return result;
+        token_t token = is_next_equal_char(s) ? TOKEN_EQUAL : TOKEN_ASSIGN;
+        return scanned_token(s, token, begin);
     }
     
     if (c == '!')
     {
-        result.value[0] = '!';
-        if (is_next_equal_char(f))
-        {
-            result.token = TOKEN_NOT_EQUAL;
-            result.value[1] = '=';
-            result.value[2] = '\0';
-            return result;
-        }
-        result.token = TOKEN_NOT;
-        result.value[1] = '\0';
-        return result;
-    }
-
-    if (isdigit(c))
-    {
-        return build_integer_token(f, c);
+        token_t token = is_next_equal_char(s) ? TOKEN_NOT_EQUAL : TOKEN_NOT;
+        return scanned_token(s, token, begin);
     }
 
-    if (c == '_' || isalpha(c))
-    {
-        return build_identifier_token(f, c);
-    }
-
-    result.value[0] = c;
-    result.value[1] = '\0';
-    result.token = TOKEN_UNKNOWN;
-    return result;
-}
\ No newline at end of file
+    return scanned_token(s, TOKEN_UNKNOWN, begin);
+}
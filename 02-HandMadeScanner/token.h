@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+
 typedef enum
 {
     TOKEN_EOF,
@@ -14,17 +16,29 @@ typedef enum
 }
 token_t;
 
-#define MAX_BUFFER_LENGTH 1024
-
-typedef char buffer_t[MAX_BUFFER_LENGTH];
-
+/*
+    A token refers to its text in the source buffer by offset and length,
+    which limits inputs to 4 GB.
+*/
 typedef struct
 {
     token_t  token;
-    buffer_t value;
+    uint32_t offset;
+    uint32_t length;
 }
 Token;
 
+_Static_assert(sizeof(Token) <= 12, "tokens should stay small enough to pass by value");
+
+Token make_token(token_t token, uint32_t offset, uint32_t length)
+{
+    Token t;
+    t.token = token;
+    t.offset = offset;
+    t.length = length;
+    return t;
+}
+
 const char* to_str(token_t t)
 {
     switch(t)
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <AlphabetCompression.hpp>
+#include <CompiledDFA.hpp>
+#include <DFA.hpp>
+
+/** Aho-Corasick automaton of a set of keywords.
+ *
+ * The states are the nodes of the trie of the keywords, numbered in
+ * breadth-first order from the root. The failure links are resolved into
+ * full transitions, so the automaton is a plain DFA: after reading a text
+ * it is in the node of the longest suffix of the text that is a prefix of
+ * a keyword, and it accepts when a keyword is a suffix of that node.
+ * Each node also links to the next node on its failure chain where a
+ * keyword ends, so all the keywords that end at a position are found in a
+ * single pass.
+ *
+ * With case folding, ASCII letters match in either case.
+ */
+class AhoCorasick
+{
+public:
+    using compiled_type = CompiledDFA<char>;
+    using state_type    = compiled_type::state_type;
+    using rule_type     = compiled_type::rule_type;
+
+    /** Occurrence of the keyword added with index keyword. */
+    struct Match
+    {
+        rule_type keyword;
+        size_t offset;
+        size_t length;
+    };
+
+    AhoCorasick(bool _fold_case = false) noexcept
+        : fold_case{_fold_case}
+    {
+
+    }
+
+    /** Adds a keyword and returns its index. A keyword added twice keeps
+     * its first index, and empty keywords are never found.
+     */
+    rule_type add(std::string_view keyword)
+    {
+        auto index = rule_type(lengths.size());
+        lengths.push_back(keyword.size());
+        keywords.emplace_back(keyword);
+        built = false;
+        return index;
+    }
+
+    size_t size() const noexcept
+    {
+        return keywords.size();
+    }
+
+    /** Automaton whose state after a text tells the keywords it ends with;
+     * its rule is the longest of them. Rules are keyword indexes.
+     */
+    const compiled_type& automaton()
+    {
+        build();
+        return dfa;
+    }
+
+    /** DFA of the texts that end with a keyword. */
+    DFA<char> to_dfa()
+    {
+        return DFA<char>::from_compiled(automaton());
+    }
+
+    /** Every occurrence of every keyword, overlaps included, by end and
+     * then from the longest keyword to the shortest.
+     */
+    std::vector<Match> find_all(std::string_view text)
+    {
+        build();
+
+        std::vector<Match> matches;
+        state_type state = dfa.initial_state();
+
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            state = dfa.delta(state, text[i]);
+
+            for (auto s = ends[state] ? state : outputs[state]; s != none; s = outputs[s])
+            {
+                auto keyword = dfa.rule(s);
+                matches.push_back({keyword, i + 1 - lengths[keyword], lengths[keyword]});
+            }
+        }
+
+        return matches;
+    }
+
+private:
+    static constexpr state_type none = compiled_type::dead_state;
+
+    unsigned char fold(unsigned char c) const noexcept
+    {
+        return fold_case && c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+    }
+
+    void build()
+    {
+        if (built)
+        {
+            return;
+        }
+
+        // Trie, 256 transitions per node.
+        std::vector<state_type> rows(256, none);
+        std::vector<rule_type> rules{compiled_type::no_rule};
+
+        for (rule_type k = 0; k < keywords.size(); ++k)
+        {
+            state_type node = 0;
+
+            if (keywords[k].empty())
+            {
+                continue;
+            }
+
+            for (char c: keywords[k])
+            {
+                size_t edge = size_t(node) * 256 + fold(c);
+
+                if (rows[edge] == none)
+                {
+                    rows[edge] = state_type(rules.size());
+                    rows.resize(rows.size() + 256, none);
+                    rules.push_back(compiled_type::no_rule);
+                }
+
+                node = rows[edge];
+            }
+
+            if (rules[node] == compiled_type::no_rule)
+            {
+                rules[node] = k;
+            }
+        }
+
+        // Breadth-first, so the failure node of a node is complete before
+        // the node is: its missing transitions are those of the failure.
+        const size_t n = rules.size();
+        std::vector<state_type> failure(n, 0);
+        std::vector<state_type> order{0};
+        outputs.assign(n, none);
+
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            state_type node = order[i];
+
+            for (size_t c = 0; c < 256; ++c)
+            {
+                if (fold(c) != c)
+                {
+                    continue;
+                }
+
+                auto& next = rows[size_t(node) * 256 + c];
+                state_type fallback = node == 0 ? 0 : rows[size_t(failure[node]) * 256 + c];
+
+                if (next == none)
+                {
+                    next = fallback;
+                    continue;
+                }
+
+                failure[next] = fallback;
+                outputs[next] = rules[fallback] != compiled_type::no_rule ? fallback : outputs[fallback];
+                order.push_back(next);
+            }
+
+            for (size_t c = 0; c < 256; ++c)
+            {
+                rows[size_t(node) * 256 + c] = rows[size_t(node) * 256 + fold(c)];
+            }
+        }
+
+        // Renumber the nodes in breadth-first order.
+        std::vector<state_type> id(n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            id[order[i]] = state_type(i);
+        }
+
+        compiled_type result{compiled_type::columns_type{}, n, 0};
+        std::vector<state_type> links(n, none);
+        ends.assign(n, false);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            state_type node = order[i];
+
+            for (compiled_type::column_type c = 0; c < 256; ++c)
+            {
+                result.set_transition(state_type(i), c, id[rows[size_t(node) * 256 + c]]);
+            }
+
+            if (rules[node] != compiled_type::no_rule)
+            {
+                result.set_accepting(state_type(i), rules[node]);
+                ends[i] = true;
+            }
+            else if (outputs[node] != none)
+            {
+                result.set_accepting(state_type(i), rules[outputs[node]]);
+            }
+
+            links[i] = outputs[node] == none ? none : id[outputs[node]];
+        }
+
+        dfa = compress_alphabet(result);
+        outputs = std::move(links);
+        built = true;
+    }
+
+    bool fold_case;
+    bool built = false;
+    std::vector<std::string> keywords;
+    std::vector<size_t> lengths;
+    compiled_type dfa{compiled_type::columns_type{}, 0, none};
+    std::vector<state_type> outputs;
+    std::vector<bool> ends;
+};
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <AlphabetCompression.hpp>
+#include <CompiledDFA.hpp>
+
+/** Boolean operations on compiled automata.
+ *
+ * The products are built on the fly: a breadth-first search from the pair
+ * of initial states visits only the reachable pairs, found again through
+ * a hash map. Two automata are compared the same way, and the search stops
+ * at the first pair on which they disagree.
+ *
+ * The alphabet of a product is the union of both alphabets. Byte automata
+ * are over all 256 bytes, so their complement is taken over all of them;
+ * for other symbols it is taken over the alphabet of the automaton.
+ */
+
+/** Columns of the union of both alphabets, and the column of each
+ * automaton for each of them.
+ *
+ * For byte symbols the shared columns are the common refinement of both
+ * class maps: two bytes share a column when they share a class in each
+ * automaton, so the products step once per class pair rather than once
+ * per byte.
+ */
+template <typename SymbolT, typename SymbolHash>
+struct SharedColumns
+{
+    using dfa_type     = CompiledDFA<SymbolT, SymbolHash>;
+    using column_type  = typename dfa_type::column_type;
+    using columns_type = typename dfa_type::columns_type;
+
+    columns_type shared;
+    std::vector<column_type> left;
+    std::vector<column_type> right;
+
+    SharedColumns(const dfa_type& a, const dfa_type& b)
+        : shared{shared_columns(a, b)}
+    {
+        for (column_type c = 0; c < shared.size(); ++c)
+        {
+            left.push_back(a.symbol_columns().column(shared.symbol(c)));
+            right.push_back(b.symbol_columns().column(shared.symbol(c)));
+        }
+    }
+
+    static columns_type shared_columns(const dfa_type& a, const dfa_type& b)
+    {
+        if constexpr (is_byte_symbol_v<SymbolT>)
+        {
+            const auto& left_classes = a.symbol_columns().class_map();
+            const auto& right_classes = b.symbol_columns().class_map();
+            typename columns_type::class_map_type classes;
+
+            // Pair of classes of each shared class, numbered by first byte.
+            std::vector<std::pair<std::uint8_t, std::uint8_t>> pairs;
+
+            for (size_t i = 0; i < classes.size(); ++i)
+            {
+                std::pair<std::uint8_t, std::uint8_t> pair{left_classes[i], right_classes[i]};
+                auto it = std::find(pairs.begin(), pairs.end(), pair);
+
+                if (it == pairs.end())
+                {
+                    it = pairs.insert(pairs.end(), pair);
+                }
+
+                classes[i] = std::uint8_t(it - pairs.begin());
+            }
+
+            return columns_type{classes};
+        }
+        else
+        {
+            std::vector<SymbolT> result;
+
+            for (const dfa_type* automaton: {&a, &b})
+            {
+                const auto& columns = automaton->symbol_columns();
+
+                for (column_type c = 0; c < columns.size(); ++c)
+                {
+                    columns.for_each_symbol(c, [&](const SymbolT& symbol) { result.push_back(symbol); });
+                }
+            }
+
+            return columns_type{result};
+        }
+    }
+};
+
+/** State of an automaton after a column, dead_state included. */
+template <typename SymbolT, typename SymbolHash>
+typename CompiledDFA<SymbolT, SymbolHash>::state_type
+product_step(const CompiledDFA<SymbolT, SymbolHash>& dfa,
+             typename CompiledDFA<SymbolT, SymbolHash>::state_type state,
+             typename CompiledDFA<SymbolT, SymbolHash>::column_type column) noexcept
+{
+    using dfa_type = CompiledDFA<SymbolT, SymbolHash>;
+
+    return state == dfa_type::dead_state || column == dfa_type::columns_type::no_column
+        ? dfa_type::dead_state
+        : dfa.column_delta(state, column);
+}
+
+/** Reachable part of the product of two automata.
+ *
+ * A pair accepts when accept(a accepts, b accepts) holds. Pairs where a
+ * is dead are never built, nor are those where b is dead when accept
+ * needs b to accept.
+ */
+template <typename SymbolT, typename SymbolHash, typename Accept>
+CompiledDFA<SymbolT, SymbolHash> product(const CompiledDFA<SymbolT, SymbolHash>& a,
+                                         const CompiledDFA<SymbolT, SymbolHash>& b, Accept accept)
+{
+    using dfa_type    = CompiledDFA<SymbolT, SymbolHash>;
+    using state_type  = typename dfa_type::state_type;
+    using column_type = typename dfa_type::column_type;
+
+    SharedColumns<SymbolT, SymbolHash> columns{a, b};
+    const bool keep_right_dead = accept(true, false);
+
+    std::unordered_map<std::uint64_t, state_type> ids;
+    std::vector<std::pair<state_type, state_type>> pairs;
+    std::vector<state_type> rows;
+
+    auto add = [&](state_type x, state_type y)
+    {
+        if (x == dfa_type::dead_state || (y == dfa_type::dead_state && !keep_right_dead))
+        {
+            return dfa_type::dead_state;
+        }
+
+        auto [it, inserted] = ids.emplace(std::uint64_t(x) << 32 | y, state_type(pairs.size()));
+
+        if (inserted)
+        {
+            pairs.emplace_back(x, y);
+        }
+
+        return it->second;
+    };
+
+    if (add(a.initial_state(), b.initial_state()) == dfa_type::dead_state)
+    {
+        return dfa_type{columns.shared, 0, dfa_type::dead_state};
+    }
+
+    for (size_t q = 0; q < pairs.size(); ++q)
+    {
+        for (column_type c = 0; c < columns.shared.size(); ++c)
+        {
+            auto [x, y] = pairs[q];
+            rows.push_back(add(product_step(a, x, columns.left[c]), product_step(b, y, columns.right[c])));
+        }
+    }
+
+    dfa_type result{columns.shared, pairs.size(), 0};
+
+    for (state_type q = 0; q < pairs.size(); ++q)
+    {
+        for (column_type c = 0; c < columns.shared.size(); ++c)
+        {
+            result.set_transition(q, c, rows[size_t(q) * columns.shared.size() + c]);
+        }
+
+        if (accept(a.is_accepting(pairs[q].first), b.is_accepting(pairs[q].second)))
+        {
+            result.set_accepting(q);
+        }
+    }
+
+    if constexpr (is_byte_symbol_v<SymbolT>)
+    {
+        return compress_alphabet(result);
+    }
+    else
+    {
+        return result;
+    }
+}
+
+/** Words accepted by both automata. */
+template <typename SymbolT, typename SymbolHash>
+CompiledDFA<SymbolT, SymbolHash> intersect(const CompiledDFA<SymbolT, SymbolHash>& a,
+                                           const CompiledDFA<SymbolT, SymbolHash>& b)
+{
+    return product(a, b, [](bool x, bool y) { return x && y; });
+}
+
+/** Words accepted by a but not by b. */
+template <typename SymbolT, typename SymbolHash>
+CompiledDFA<SymbolT, SymbolHash> difference(const CompiledDFA<SymbolT, SymbolHash>& a,
+                                            const CompiledDFA<SymbolT, SymbolHash>& b)
+{
+    return product(a, b, [](bool x, bool y) { return x && !y; });
+}
+
+/** Words the automaton rejects. Its dead state becomes an accepting sink. */
+template <typename SymbolT, typename SymbolHash>
+CompiledDFA<SymbolT, SymbolHash> complement(const CompiledDFA<SymbolT, SymbolHash>& dfa)
+{
+    using dfa_type    = CompiledDFA<SymbolT, SymbolHash>;
+    using state_type  = typename dfa_type::state_type;
+    using column_type = typename dfa_type::column_type;
+
+    const auto sink = state_type(dfa.num_states());
+    const auto initial = dfa.initial_state() == dfa_type::dead_state ? sink : dfa.initial_state();
+    dfa_type result{dfa.symbol_columns(), dfa.num_states() + 1, initial};
+
+    for (state_type q = 0; q <= sink; ++q)
+    {
+        for (column_type c = 0; c < dfa.num_columns(); ++c)
+        {
+            auto next = q == sink ? dfa_type::dead_state : dfa.column_delta(q, c);
+            result.set_transition(q, c, next == dfa_type::dead_state ? sink : next);
+        }
+
+        if (q == sink || !dfa.is_accepting(q))
+        {
+            result.set_accepting(q);
+        }
+    }
+
+    result.accelerate();
+
+    return result;
+}
+
+/** Shortest word accepted by exactly one of the automata, if there is one.
+ *
+ * The search stops at the first pair of states that disagree.
+ */
+template <typename SymbolT, typename SymbolHash>
+std::optional<std::vector<SymbolT>> counterexample(const CompiledDFA<SymbolT, SymbolHash>& a,
+                                                   const CompiledDFA<SymbolT, SymbolHash>& b)
+{
+    using dfa_type    = CompiledDFA<SymbolT, SymbolHash>;
+    using state_type  = typename dfa_type::state_type;
+    using column_type = typename dfa_type::column_type;
+
+    SharedColumns<SymbolT, SymbolHash> columns{a, b};
+
+    std::unordered_map<std::uint64_t, size_t> visited;
+    std::vector<std::pair<state_type, state_type>> pairs;
+
+    // Pair each one was reached from, and on which column.
+    std::vector<std::pair<size_t, column_type>> parents;
+
+    auto word_to = [&](size_t q)
+    {
+        std::vector<SymbolT> word;
+
+        for (; q != 0; q = parents[q].first)
+        {
+            word.push_back(columns.shared.symbol(parents[q].second));
+        }
+
+        std::reverse(word.begin(), word.end());
+        return word;
+    };
+
+    pairs.emplace_back(a.initial_state(), b.initial_state());
+    parents.emplace_back(0, 0);
+    visited.emplace(std::uint64_t(pairs[0].first) << 32 | pairs[0].second, 0);
+
+    for (size_t q = 0; q < pairs.size(); ++q)
+    {
+        auto [x, y] = pairs[q];
+
+        if (a.is_accepting(x) != b.is_accepting(y))
+        {
+            return word_to(q);
+        }
+
+        for (column_type c = 0; c < columns.shared.size(); ++c)
+        {
+            state_type nx = product_step(a, x, columns.left[c]);
+            state_type ny = product_step(b, y, columns.right[c]);
+
+            if (nx == dfa_type::dead_state && ny == dfa_type::dead_state)
+            {
+                continue;
+            }
+
+            if (visited.emplace(std::uint64_t(nx) << 32 | ny, pairs.size()).second)
+            {
+                pairs.emplace_back(nx, ny);
+                parents.emplace_back(q, c);
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+/** Whether both automata accept the same words. */
+template <typename SymbolT, typename SymbolHash>
+bool equivalent(const CompiledDFA<SymbolT, SymbolHash>& a, const CompiledDFA<SymbolT, SymbolHash>& b)
+{
+    return !counterexample(a, b);
+}
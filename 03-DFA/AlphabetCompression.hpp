@@ -0,0 +1,76 @@
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include <CompiledDFA.hpp>
+
+/** Merges the byte columns of a compiled DFA that are equal in every state.
+ *
+ * The result maps each byte to its equivalence class and has one column
+ * per class, so automata over a few character ranges need a handful of
+ * columns instead of 256. The result is accelerated.
+ */
+template <typename SymbolT, typename SymbolHash>
+CompiledDFA<SymbolT, SymbolHash> compress_alphabet(const CompiledDFA<SymbolT, SymbolHash>& dfa)
+{
+    static_assert(is_byte_symbol_v<SymbolT>, "Only byte automata have a class map");
+
+    using dfa_type     = CompiledDFA<SymbolT, SymbolHash>;
+    using state_type   = typename dfa_type::state_type;
+    using column_type  = typename dfa_type::column_type;
+    using columns_type = typename dfa_type::columns_type;
+
+    const auto& columns = dfa.symbol_columns();
+
+    // Class of every old column, numbered by the first byte that uses it.
+    std::map<std::vector<state_type>, std::uint8_t> classes;
+    std::vector<int> class_of_column(columns.size(), -1);
+    std::vector<column_type> representatives;
+    typename columns_type::class_map_type class_map;
+
+    for (size_t byte = 0; byte < 256; ++byte)
+    {
+        column_type old = columns.column(static_cast<SymbolT>(byte));
+
+        if (class_of_column[old] < 0)
+        {
+            std::vector<state_type> targets(dfa.num_states());
+
+            for (state_type q = 0; q < dfa.num_states(); ++q)
+            {
+                targets[q] = dfa.column_delta(q, old);
+            }
+
+            auto [it, inserted] = classes.emplace(std::move(targets), std::uint8_t(classes.size()));
+
+            if (inserted)
+            {
+                representatives.push_back(old);
+            }
+
+            class_of_column[old] = it->second;
+        }
+
+        class_map[byte] = std::uint8_t(class_of_column[old]);
+    }
+
+    dfa_type result{columns_type{class_map}, dfa.num_states(), dfa.initial_state()};
+
+    for (state_type q = 0; q < dfa.num_states(); ++q)
+    {
+        for (column_type c = 0; c < representatives.size(); ++c)
+        {
+            result.set_transition(q, c, dfa.column_delta(q, representatives[c]));
+        }
+
+        if (dfa.is_accepting(q))
+        {
+            result.set_accepting(q, dfa.rule(q));
+        }
+    }
+
+    result.accelerate();
+
+    return result;
+}
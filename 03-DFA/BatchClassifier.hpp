@@ -0,0 +1,335 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <CompiledDFA.hpp>
+
+/** Read-only memory mapping of a whole file. */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator = (const MappedFile&) = delete;
+
+    ~MappedFile() noexcept
+    {
+        close();
+    }
+
+    /** Returns false if the file can not be mapped. An empty file maps to
+     * an empty view.
+     */
+    bool open(const std::string& path) noexcept
+    {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat info;
+
+        if (fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        if (info.st_size > 0)
+        {
+            void* address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (address == MAP_FAILED)
+            {
+                ::close(fd);
+                return false;
+            }
+
+            madvise(address, info.st_size, MADV_SEQUENTIAL);
+            mapping = static_cast<const char*>(address);
+            mapping_size = info.st_size;
+        }
+
+        ::close(fd);
+        return true;
+    }
+
+    void close() noexcept
+    {
+        if (mapping != nullptr)
+        {
+            munmap(const_cast<char*>(mapping), mapping_size);
+        }
+
+        mapping = nullptr;
+        mapping_size = 0;
+    }
+
+    std::string_view view() const noexcept
+    {
+        return {mapping, mapping_size};
+    }
+
+private:
+    const char* mapping = nullptr;
+    size_t mapping_size = 0;
+};
+
+/** Runs task(0), ..., task(count - 1) on a pool of threads.
+ *
+ * Each thread starts with a contiguous range of the tasks and takes them
+ * from the front. A thread that runs out steals the back half of the
+ * range of another one, so a few slow tasks do not leave the others idle.
+ */
+template <typename Task>
+void run_stealing(size_t count, unsigned threads, Task task)
+{
+    struct Range
+    {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    threads = std::max(1u, threads);
+    std::vector<Range> ranges(threads);
+
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        ranges[t].begin = count * t / threads;
+        ranges[t].end = count * (t + 1) / threads;
+    }
+
+    auto worker = [&](unsigned t)
+    {
+        Range& own = ranges[t];
+
+        for (;;)
+        {
+            size_t next = SIZE_MAX;
+
+            {
+                std::lock_guard<std::mutex> lock{own.mutex};
+
+                if (own.begin < own.end)
+                {
+                    next = own.begin++;
+                }
+            }
+
+            if (next != SIZE_MAX)
+            {
+                task(next);
+                continue;
+            }
+
+            bool stolen = false;
+
+            for (unsigned i = 1; i < threads && !stolen; ++i)
+            {
+                Range& victim = ranges[(t + i) % threads];
+                size_t begin, end;
+
+                {
+                    std::lock_guard<std::mutex> lock{victim.mutex};
+
+                    if (victim.begin >= victim.end)
+                    {
+                        continue;
+                    }
+
+                    end = victim.end;
+                    begin = victim.begin + (victim.end - victim.begin) / 2;
+                    victim.end = begin;
+                }
+
+                // The victim keeps the front half, which may be empty when
+                // it had a single task left.
+                std::lock_guard<std::mutex> lock{own.mutex};
+                own.begin = begin;
+                own.end = end;
+                stolen = true;
+            }
+
+            if (!stolen)
+            {
+                return;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+
+    for (unsigned t = 1; t < threads; ++t)
+    {
+        pool.emplace_back(worker, t);
+    }
+
+    worker(0);
+
+    for (auto& thread: pool)
+    {
+        thread.join();
+    }
+}
+
+/** Classifies every line of a text with a compiled byte automaton.
+ *
+ * The text is cut at line boundaries into chunks that are classified in
+ * parallel. A first pass counts the lines of each chunk, so that a second
+ * one can write the rule of each line straight to its place in the result:
+ * the order of the input is kept and the workers allocate nothing. A
+ * carriage return before a newline is not part of the line.
+ */
+template <typename SymbolHash>
+class BatchClassifier
+{
+public:
+    using dfa_type  = CompiledDFA<char, SymbolHash>;
+    using rule_type = typename dfa_type::rule_type;
+
+    static constexpr rule_type no_rule = dfa_type::no_rule;
+    static constexpr size_t chunk_size = 1 << 20;
+
+    BatchClassifier(const dfa_type& _dfa, unsigned _threads = std::thread::hardware_concurrency()) noexcept
+        : dfa{_dfa}, threads{std::max(1u, _threads)}
+    {
+
+    }
+
+    std::vector<rule_type> classify(std::string_view text) const
+    {
+        std::vector<size_t> bounds{0};
+
+        while (bounds.back() < text.size())
+        {
+            size_t end = std::min(bounds.back() + chunk_size, text.size());
+            auto newline = static_cast<const char*>(std::memchr(text.data() + end - 1, '\n', text.size() - end + 1));
+            bounds.push_back(newline == nullptr ? text.size() : size_t(newline - text.data()) + 1);
+        }
+
+        size_t chunks = bounds.size() - 1;
+        std::vector<size_t> first_line(chunks + 1, 0);
+
+        run_stealing(chunks, threads, [&](size_t i)
+        {
+            auto chunk = text.substr(bounds[i], bounds[i + 1] - bounds[i]);
+            first_line[i + 1] = std::count(chunk.begin(), chunk.end(), '\n') + (chunk.back() != '\n');
+        });
+
+        for (size_t i = 0; i < chunks; ++i)
+        {
+            first_line[i + 1] += first_line[i];
+        }
+
+        std::vector<rule_type> rules(first_line.back());
+
+        run_stealing(chunks, threads, [&](size_t i)
+        {
+            size_t line = first_line[i];
+
+            for (size_t begin = bounds[i]; begin < bounds[i + 1]; ++line)
+            {
+                auto newline = static_cast<const char*>(std::memchr(text.data() + begin, '\n', bounds[i + 1] - begin));
+                size_t end = newline == nullptr ? bounds[i + 1] : size_t(newline - text.data());
+                size_t length = end - begin;
+
+                if (length > 0 && text[end - 1] == '\r')
+                {
+                    --length;
+                }
+
+                rules[line] = dfa.classify(text.substr(begin, length));
+                begin = end + 1;
+            }
+        });
+
+        return rules;
+    }
+
+private:
+    const dfa_type& dfa;
+    unsigned threads;
+};
+
+/** Writes one rule per line, -1 when no rule matches. */
+template <typename RuleT>
+void write_csv(const std::vector<RuleT>& rules, std::ostream& output)
+{
+    std::string buffer;
+
+    for (auto rule: rules)
+    {
+        buffer += rule == RuleT(-1) ? "-1" : std::to_string(rule);
+        buffer += '\n';
+
+        if (buffer.size() >= 1 << 16)
+        {
+            output << buffer;
+            buffer.clear();
+        }
+    }
+
+    output << buffer;
+}
+
+/** Header of the binary output of write_binary.
+ *
+ * It is followed by count entries of width bytes each, in the byte order
+ * of the host: bytes with 255 when no rule matches, or 32-bit integers
+ * with UINT32_MAX when no rule matches.
+ */
+struct BatchRulesHeader
+{
+    static constexpr std::uint32_t magic_number = 0x314c5552; // "RUL1"
+
+    std::uint32_t magic;
+    std::uint32_t width;
+    std::uint64_t count;
+};
+
+/** Writes the header and then the rules as a column of bytes if they all
+ * fit, or else of 32-bit integers.
+ */
+template <typename RuleT>
+void write_binary(const std::vector<RuleT>& rules, std::ostream& output)
+{
+    static_assert(sizeof(RuleT) == sizeof(std::uint32_t), "Wide entries are 32-bit integers");
+
+    bool narrow = std::all_of(rules.begin(), rules.end(), [](RuleT rule) { return rule == RuleT(-1) || rule < 255; });
+
+    BatchRulesHeader header{};
+    header.magic = BatchRulesHeader::magic_number;
+    header.width = narrow ? 1 : sizeof(RuleT);
+    header.count = rules.size();
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if (!narrow)
+    {
+        output.write(reinterpret_cast<const char*>(rules.data()), rules.size() * sizeof(RuleT));
+        return;
+    }
+
+    std::vector<std::uint8_t> bytes(rules.size());
+    std::transform(rules.begin(), rules.end(), bytes.begin(), [](RuleT rule) { return std::uint8_t(rule); });
+    output.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
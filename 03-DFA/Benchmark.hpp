@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <DemoAutomata.hpp>
+
+/** The input used to time the automata of DFA_demo, shared by the
+ * benchmarks.
+ */
+
+constexpr std::string_view word_symbols = "abcdefghijklmnopqrstuvwxyz0123456789";
+constexpr std::string_view digit_symbols = "0123456789";
+
+/** Random words over the given symbols, the same ones on every run. */
+inline std::vector<std::string> make_words(size_t count, size_t length,
+                                           std::string_view symbols = word_symbols)
+{
+    std::mt19937 generator{42};
+    std::uniform_int_distribution<size_t> pick{0, symbols.size() - 1};
+    std::vector<std::string> words(count);
+
+    for (auto& word: words)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            word.push_back(symbols[pick(generator)]);
+        }
+    }
+
+    return words;
+}
+
+/** Matches every word several times and returns the throughput in MB/s.
+ *
+ * Matcher is any callable that takes a std::string_view and returns bool.
+ */
+template <typename Matcher>
+double throughput(Matcher match, const std::vector<std::string>& words, size_t& matches)
+{
+    constexpr size_t rounds = 20;
+
+    size_t bytes = 0;
+    matches = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        for (const auto& word: words)
+        {
+            matches += match(std::string_view{word});
+            bytes += word.size();
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return bytes / elapsed.count() / (1 << 20);
+}
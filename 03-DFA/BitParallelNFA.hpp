@@ -0,0 +1,349 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <Regex.hpp>
+#include <Search.hpp>
+
+/** Glushkov automaton of a small regular expression, simulated with one
+ * bit per position, after Navarro and Raffinot.
+ *
+ * The positions are the leaves of the expression, at most 64 of them, and
+ * a set of active positions is a 64-bit word. A step is
+ *
+ *     active = follow(active) & masks[byte]
+ *
+ * where follow() looks up the union of the followers of each byte of the
+ * set in a precomputed table. No DFA is built, so the cost does not depend
+ * on how large the DFA would be.
+ *
+ * A search runs forwards from every start and keeps the earliest run that
+ * matches. find_all instead scans the whole text backwards once with the
+ * reverse automaton to mark where matches start, then forwards from each
+ * start for the longest end. Empty matches are not reported.
+ */
+class BitParallelNFA
+{
+public:
+    using set_type   = std::uint64_t;
+    using word_type  = std::string_view;
+    using match_type = Searcher<char, std::hash<char>>::Match;
+
+    static constexpr size_t max_positions = 64;
+
+    /** Builds the automaton, the result is empty when the expression has
+     * more than max_positions leaves.
+     */
+    static std::optional<BitParallelNFA> build(const Regex& regex)
+    {
+        BitParallelNFA result;
+        auto root = result.glushkov(regex, regex.root());
+
+        if (result.positions > max_positions)
+        {
+            return std::nullopt;
+        }
+
+        result.nullable = root.nullable;
+        result.first = root.first;
+        result.last = root.last;
+        result.forward.fill(result.follow, result.positions);
+
+        // The reverse automaton swaps first and last and transposes follow.
+        std::vector<set_type> precede(result.positions, 0);
+
+        for (size_t i = 0; i < result.positions; ++i)
+        {
+            for (size_t j = 0; j < result.positions; ++j)
+            {
+                if ((result.follow[i] >> j) & 1)
+                {
+                    precede[j] |= set_type{1} << i;
+                }
+            }
+        }
+
+        result.backward.fill(precede, result.positions);
+
+        return result;
+    }
+
+    size_t size() const noexcept
+    {
+        return positions;
+    }
+
+    bool match(word_type word) const noexcept
+    {
+        if (word.empty())
+        {
+            return nullable;
+        }
+
+        set_type active = first & masks[byte(word[0])];
+
+        for (size_t i = 1; i < word.size() && active != 0; ++i)
+        {
+            active = forward.next(active) & masks[byte(word[i])];
+        }
+
+        return (active & last) != 0;
+    }
+
+    /** Leftmost-longest match that starts at offset or after it.
+     *
+     * A forward pass runs the automaton from every start, earliest run
+     * first, as the forward automaton of Searcher does with its states. A
+     * position reached by two runs is kept for the earlier one, so the
+     * runs are disjoint and there are at most max_positions of them. Once
+     * a run accepts, the later ones are dropped and no new start is taken,
+     * and the pass stops when the remaining runs die. The scan therefore
+     * ends a little past the match rather than at the end of the text.
+     */
+    std::optional<match_type> search(word_type text, size_t offset = 0) const noexcept
+    {
+        struct Run
+        {
+            size_t start;
+            set_type active;
+        };
+
+        std::array<Run, max_positions> runs;
+        size_t count = 0;
+        std::optional<match_type> result;
+
+        for (size_t i = offset; i < text.size(); ++i)
+        {
+            set_type mask = masks[byte(text[i])];
+            set_type claimed = 0;
+            size_t kept = 0;
+
+            for (size_t r = 0; r < count; ++r)
+            {
+                set_type active = forward.next(runs[r].active) & mask & ~claimed;
+
+                if (active == 0)
+                {
+                    continue;
+                }
+
+                claimed |= active;
+                runs[kept++] = {runs[r].start, active};
+
+                if (active & last)
+                {
+                    result = match_type{runs[r].start, i + 1 - runs[r].start};
+                    break;
+                }
+            }
+
+            count = kept;
+
+            set_type started = first & mask & ~claimed;
+
+            if (!result && started != 0)
+            {
+                runs[count++] = {i, started};
+
+                if (started & last)
+                {
+                    result = match_type{i, 1};
+                }
+            }
+
+            if (result && count == 0)
+            {
+                break;
+            }
+        }
+
+        return result;
+    }
+
+    /** Every leftmost-longest match, left to right, without overlaps.
+     *
+     * A single backward pass marks where matches start.
+     */
+    std::vector<match_type> find_all(word_type text) const
+    {
+        std::vector<bool> starts(text.size(), false);
+        set_type active = 0;
+
+        for (size_t i = text.size(); i > 0; --i)
+        {
+            active = (backward.next(active) | last) & masks[byte(text[i - 1])];
+            starts[i - 1] = (active & first) != 0;
+        }
+
+        std::vector<match_type> matches;
+
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            if (starts[i])
+            {
+                matches.push_back({i, longest(text, i)});
+                i += matches.back().length - 1;
+            }
+        }
+
+        return matches;
+    }
+
+private:
+    /** Union of the followers of a set, eight positions per lookup. */
+    struct FollowTable
+    {
+        std::vector<std::array<set_type, 256>> chunks;
+
+        void fill(const std::vector<set_type>& follow, size_t positions)
+        {
+            chunks.assign((positions + 7) / 8, {});
+
+            for (size_t k = 0; k < chunks.size(); ++k)
+            {
+                for (size_t bits = 1; bits < 256; ++bits)
+                {
+                    size_t low = bits & (bits - 1);
+                    size_t position = k * 8 + __builtin_ctz(unsigned(bits));
+                    chunks[k][bits] = chunks[k][low] | (position < positions ? follow[position] : 0);
+                }
+            }
+        }
+
+        set_type next(set_type active) const noexcept
+        {
+            set_type result = 0;
+
+            for (size_t k = 0; k < chunks.size() && active != 0; ++k, active >>= 8)
+            {
+                result |= chunks[k][active & 0xff];
+            }
+
+            return result;
+        }
+    };
+
+    struct Fragment
+    {
+        bool nullable;
+        set_type first;
+        set_type last;
+    };
+
+    static unsigned char byte(char c) noexcept
+    {
+        return static_cast<unsigned char>(c);
+    }
+
+    /** Length of the longest non-empty match that starts at the offset, for
+     * an offset where one is known to start.
+     */
+    size_t longest(word_type text, size_t offset) const noexcept
+    {
+        set_type active = first & masks[byte(text[offset])];
+        size_t length = 1;
+
+        for (size_t i = offset + 1; i < text.size() && active != 0; ++i)
+        {
+            active = forward.next(active) & masks[byte(text[i])];
+
+            if (active & last)
+            {
+                length = i + 1 - offset;
+            }
+        }
+
+        return length;
+    }
+
+    void link(set_type from, set_type to) noexcept
+    {
+        for (size_t i = 0; i < positions && i < max_positions; ++i)
+        {
+            if ((from >> i) & 1)
+            {
+                follow[i] |= to;
+            }
+        }
+    }
+
+    /** Numbers the leaves and fills follow, past max_positions it only
+     * counts them.
+     */
+    Fragment glushkov(const Regex& regex, Regex::index_type index)
+    {
+        const RegexNode& node = regex.node(index);
+
+        switch (node.kind)
+        {
+            case RegexNode::Kind::Empty:
+                return {true, 0, 0};
+            case RegexNode::Kind::Symbols:
+            {
+                size_t position = positions++;
+
+                if (position >= max_positions)
+                {
+                    return {false, 0, 0};
+                }
+
+                follow.push_back(0);
+
+                for (size_t symbol = 0; symbol < 256; ++symbol)
+                {
+                    if (node.symbols.test(symbol))
+                    {
+                        masks[symbol] |= set_type{1} << position;
+                    }
+                }
+
+                return {false, set_type{1} << position, set_type{1} << position};
+            }
+            case RegexNode::Kind::Concatenation:
+            {
+                auto left = glushkov(regex, node.left);
+                auto right = glushkov(regex, node.right);
+                link(left.last, right.first);
+                return {left.nullable && right.nullable,
+                        left.nullable ? left.first | right.first : left.first,
+                        right.nullable ? left.last | right.last : right.last};
+            }
+            case RegexNode::Kind::Alternation:
+            {
+                auto left = glushkov(regex, node.left);
+                auto right = glushkov(regex, node.right);
+                return {left.nullable || right.nullable, left.first | right.first, left.last | right.last};
+            }
+            case RegexNode::Kind::Group:
+                return glushkov(regex, node.left);
+            case RegexNode::Kind::Star:
+            case RegexNode::Kind::Plus:
+            case RegexNode::Kind::Optional:
+            {
+                auto inner = glushkov(regex, node.left);
+
+                if (node.kind != RegexNode::Kind::Optional)
+                {
+                    link(inner.last, inner.first);
+                }
+
+                return {inner.nullable || node.kind != RegexNode::Kind::Plus, inner.first, inner.last};
+            }
+        }
+
+        return {false, 0, 0};
+    }
+
+    size_t positions = 0;
+    bool nullable = false;
+    set_type first = 0;
+    set_type last = 0;
+    std::vector<set_type> follow;
+    std::array<set_type, 256> masks{};
+    FollowTable forward;
+    FollowTable backward;
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <CompiledDFA.hpp>
+
+/** Writes a byte as a C character literal, or as a number when it is not
+ * printable.
+ */
+inline void write_byte(std::ostream& output, int byte)
+{
+    if (byte >= 0x20 && byte < 0x7f && byte != '\'' && byte != '\\')
+    {
+        output << '\'' << char(byte) << '\'';
+    }
+    else
+    {
+        output << byte;
+    }
+}
+
+/** Emits a direct-coded matcher for a byte DFA.
+ *
+ * The generated function has the signature
+ *
+ *     bool function_name(std::string_view word) noexcept
+ *
+ * and has one label per state. Each state reads a byte and jumps to the
+ * next label after comparing it with the byte ranges of its transitions,
+ * so no transition table is involved.
+ */
+template <typename SymbolT, typename SymbolHash>
+void generate_cpp(const CompiledDFA<SymbolT, SymbolHash>& dfa, std::ostream& output,
+                  std::string_view function_name)
+{
+    static_assert(is_byte_symbol_v<SymbolT>, "Only byte automata can be direct-coded");
+
+    using dfa_type   = CompiledDFA<SymbolT, SymbolHash>;
+    using state_type = typename dfa_type::state_type;
+
+    output << "inline bool " << function_name << "(std::string_view word) noexcept\n"
+           << "{\n"
+           << "    const char* p = word.data();\n"
+           << "    const char* end = p + word.size();\n"
+           << "    unsigned char c;\n\n"
+           << "    goto s" << dfa.initial_state() << ";\n";
+
+    for (state_type q = 0; q < dfa.num_states(); ++q)
+    {
+        output << "\ns" << q << ":\n"
+               << "    if (p == end)\n"
+               << "    {\n"
+               << "        return " << (dfa.is_accepting(q) ? "true" : "false") << ";\n"
+               << "    }\n\n"
+               << "    c = static_cast<unsigned char>(*p++);\n\n";
+
+        // Byte ranges of the transitions, grouped by target state.
+        std::map<state_type, std::vector<std::pair<int, int>>> ranges;
+
+        for (int byte = 0; byte < 256; ++byte)
+        {
+            state_type next = dfa.delta(q, static_cast<SymbolT>(byte));
+
+            if (next == dfa_type::dead_state)
+            {
+                continue;
+            }
+
+            auto& target_ranges = ranges[next];
+
+            if (!target_ranges.empty() && target_ranges.back().second == byte - 1)
+            {
+                target_ranges.back().second = byte;
+            }
+            else
+            {
+                target_ranges.emplace_back(byte, byte);
+            }
+        }
+
+        for (const auto& [next, target_ranges]: ranges)
+        {
+            output << "    if (";
+
+            for (size_t i = 0; i < target_ranges.size(); ++i)
+            {
+                auto [low, high] = target_ranges[i];
+
+                if (i > 0)
+                {
+                    output << " ||\n        ";
+                }
+
+                if (low == high)
+                {
+                    output << "c == ";
+                    write_byte(output, low);
+                }
+                else
+                {
+                    output << "(c >= ";
+                    write_byte(output, low);
+                    output << " && c <= ";
+                    write_byte(output, high);
+                    output << ")";
+                }
+            }
+
+            output << ")\n"
+                   << "    {\n"
+                   << "        goto s" << next << ";\n"
+                   << "    }\n\n";
+        }
+
+        output << "    return false;\n";
+    }
+
+    output << "}\n";
+}
@@ -0,0 +1,441 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <SelfLoop.hpp>
+
+/** Whether a symbol type is small enough to index a table by its value. */
+template <typename SymbolT>
+constexpr bool is_byte_symbol_v = std::is_integral_v<SymbolT> && sizeof(SymbolT) == 1;
+
+/** Maps the symbols of an automaton to the columns of a flat transition
+ * table.
+ *
+ * The general version keeps one column per distinct symbol used by the
+ * automaton and finds it by hashing the symbol.
+ */
+template <typename SymbolT, typename SymbolHash = std::hash<SymbolT>, typename = void>
+class SymbolColumns
+{
+public:
+    using symbol_type = SymbolT;
+    using column_type = std::uint32_t;
+
+    static constexpr column_type no_column = std::numeric_limits<column_type>::max();
+
+    SymbolColumns() = default;
+
+    SymbolColumns(const std::vector<symbol_type>& symbols)
+    {
+        for (const auto& symbol: symbols)
+        {
+            if (index.emplace(symbol, column_type(alphabet.size())).second)
+            {
+                alphabet.push_back(symbol);
+            }
+        }
+    }
+
+    column_type column(const symbol_type& symbol) const noexcept
+    {
+        auto it = index.find(symbol);
+        return it == index.end() ? no_column : it->second;
+    }
+
+    column_type size() const noexcept
+    {
+        return column_type(alphabet.size());
+    }
+
+    const symbol_type& symbol(column_type column) const noexcept
+    {
+        return alphabet[column];
+    }
+
+    template <typename Function>
+    void for_each_symbol(column_type column, Function function) const
+    {
+        function(alphabet[column]);
+    }
+
+private:
+    std::unordered_map<symbol_type, column_type, SymbolHash> index;
+    std::vector<symbol_type> alphabet;
+};
+
+/** Byte symbols are mapped to equivalence classes through a 256 entry
+ * array. Bytes share a class when every state moves the same way on them,
+ * so the table only needs one column per class. By default every byte is
+ * its own class.
+ */
+template <typename SymbolT, typename SymbolHash>
+class SymbolColumns<SymbolT, SymbolHash, std::enable_if_t<is_byte_symbol_v<SymbolT>>>
+{
+public:
+    using symbol_type = SymbolT;
+    using column_type = std::uint32_t;
+    using class_map_type = std::array<std::uint8_t, 256>;
+
+    static constexpr column_type no_column = std::numeric_limits<column_type>::max();
+
+    SymbolColumns() noexcept
+    {
+        for (size_t i = 0; i < classes.size(); ++i)
+        {
+            classes[i] = std::uint8_t(i);
+        }
+    }
+
+    SymbolColumns(const std::vector<symbol_type>&) noexcept
+        : SymbolColumns{}
+    {
+
+    }
+
+    /** Classes must be numbered from 0 without gaps. */
+    SymbolColumns(const class_map_type& _classes) noexcept
+        : classes{_classes}, count{0}
+    {
+        for (auto c: classes)
+        {
+            count = std::max(count, column_type(c) + 1);
+        }
+    }
+
+    column_type column(symbol_type symbol) const noexcept
+    {
+        return classes[static_cast<unsigned char>(symbol)];
+    }
+
+    column_type size() const noexcept
+    {
+        return count;
+    }
+
+    /** Smallest byte of the class. */
+    symbol_type symbol(column_type column) const noexcept
+    {
+        size_t i = 0;
+
+        while (classes[i] != column)
+        {
+            ++i;
+        }
+
+        return static_cast<symbol_type>(i);
+    }
+
+    template <typename Function>
+    void for_each_symbol(column_type column, Function function) const
+    {
+        for (size_t i = 0; i < classes.size(); ++i)
+        {
+            if (classes[i] == column)
+            {
+                function(static_cast<symbol_type>(i));
+            }
+        }
+    }
+
+    const class_map_type& class_map() const noexcept
+    {
+        return classes;
+    }
+
+private:
+    class_map_type classes;
+    column_type count = 256;
+};
+
+/** Compiled form of a DFA.
+ *
+ * States are contiguous integers in [0, num_states()), the transition
+ * function is a flat num_states() x num_columns() array and the
+ * acceptation states are kept in a bitset. Missing transitions go to
+ * dead_state, which is not a row of the table.
+ *
+ * Every acceptation state is also tagged with the id of the rule it
+ * accepts, which is 0 unless the automaton recognizes several patterns.
+ *
+ * Byte automata can be accelerated: the states that loop to themselves on
+ * a few byte ranges skip runs of those bytes with SIMD comparisons.
+ */
+template <typename SymbolT, typename SymbolHash = std::hash<SymbolT>>
+class CompiledDFA
+{
+public:
+    using state_type   = std::uint32_t;
+    using symbol_type  = SymbolT;
+    using word_type    = std::basic_string_view<symbol_type>;
+    using columns_type = SymbolColumns<SymbolT, SymbolHash>;
+    using column_type  = typename columns_type::column_type;
+    using rule_type    = std::uint32_t;
+
+    static constexpr state_type dead_state = std::numeric_limits<state_type>::max();
+    static constexpr rule_type no_rule = std::numeric_limits<rule_type>::max();
+
+    CompiledDFA() = default;
+
+    CompiledDFA(columns_type _columns, size_t _states, state_type _initial)
+        : columns{std::move(_columns)},
+          states_count{_states},
+          initial{_initial},
+          table(_states * columns.size(), dead_state),
+          accepting((_states + 63) / 64, 0),
+          rules(_states, no_rule)
+    {
+
+    }
+
+    /** Changing a transition drops the acceleration of the automaton. */
+    void set_transition(state_type state0, column_type column, state_type state1) noexcept
+    {
+        table[size_t(state0) * columns.size() + column] = state1;
+        loops.clear();
+    }
+
+    /** Finds the states that loop to themselves on at most
+     * SelfLoop::max_ranges byte ranges, so that matching skips over them.
+     * It does nothing for automata over other symbols.
+     */
+    void accelerate(bool enable = true)
+    {
+        loops.clear();
+
+        if constexpr (is_byte_symbol_v<SymbolT>)
+        {
+            if (!enable)
+            {
+                return;
+            }
+
+            std::vector<SelfLoop> found(states_count);
+            bool any = false;
+
+            for (state_type q = 0; q < states_count; ++q)
+            {
+                // Ranges of bytes that loop on q, as [low, high] pairs.
+                int ranges[SelfLoop::max_ranges][2];
+                unsigned count = 0;
+                bool fits = true;
+
+                for (int byte = 0; byte < 256 && fits; ++byte)
+                {
+                    if (delta(q, static_cast<symbol_type>(byte)) != q)
+                    {
+                        continue;
+                    }
+
+                    if (count > 0 && ranges[count - 1][1] == byte - 1)
+                    {
+                        ranges[count - 1][1] = byte;
+                    }
+                    else if (count < SelfLoop::max_ranges)
+                    {
+                        ranges[count][0] = ranges[count][1] = byte;
+                        ++count;
+                    }
+                    else
+                    {
+                        fits = false;
+                    }
+                }
+
+                for (unsigned i = 0; fits && i < count; ++i)
+                {
+                    found[q].add_range(std::uint8_t(ranges[i][0]), std::uint8_t(ranges[i][1]));
+                    any = true;
+                }
+            }
+
+            if (any)
+            {
+                loops = std::move(found);
+            }
+        }
+    }
+
+    bool is_accelerated() const noexcept
+    {
+        return !loops.empty();
+    }
+
+    void set_accepting(state_type state, rule_type rule = 0) noexcept
+    {
+        accepting[state / 64] |= std::uint64_t{1} << (state % 64);
+        rules[state] = rule;
+    }
+
+    state_type initial_state() const noexcept
+    {
+        return initial;
+    }
+
+    size_t num_states() const noexcept
+    {
+        return states_count;
+    }
+
+    column_type num_columns() const noexcept
+    {
+        return columns.size();
+    }
+
+    const columns_type& symbol_columns() const noexcept
+    {
+        return columns;
+    }
+
+    /** Bytes used by the transition table and the acceptation bitset. */
+    size_t table_size() const noexcept
+    {
+        return table.size() * sizeof(state_type) + accepting.size() * sizeof(std::uint64_t) +
+            rules.size() * sizeof(rule_type);
+    }
+
+    state_type column_delta(state_type state, column_type column) const noexcept
+    {
+        return table[size_t(state) * columns.size() + column];
+    }
+
+    state_type delta(state_type state, const symbol_type& symbol) const noexcept
+    {
+        auto column = columns.column(symbol);
+        return column == columns_type::no_column ? dead_state : column_delta(state, column);
+    }
+
+    bool is_accepting(state_type state) const noexcept
+    {
+        return state != dead_state && (accepting[state / 64] >> (state % 64)) & 1;
+    }
+
+    /** Rule accepted at the state, no_rule if it is not an acceptation state. */
+    rule_type rule(state_type state) const noexcept
+    {
+        return state == dead_state ? no_rule : rules[state];
+    }
+
+    /** Resumable matcher that consumes a word in chunks.
+     *
+     * It only keeps the current state, so feeding runs in constant stack
+     * and does not allocate.
+     */
+    class Cursor
+    {
+    public:
+        Cursor(const CompiledDFA& _dfa) noexcept
+            : dfa{&_dfa}, current{_dfa.initial_state()}
+        {
+
+        }
+
+        /** Cursor that resumes from the given state. */
+        Cursor(const CompiledDFA& _dfa, state_type state) noexcept
+            : dfa{&_dfa}, current{state}
+        {
+
+        }
+
+        void reset() noexcept
+        {
+            current = dfa->initial_state();
+        }
+
+        /** Consumes the next chunk of the word.
+         *
+         * Returns false once the dead state is reached; no later chunk
+         * can make the word accepted.
+         */
+        bool feed(word_type chunk) noexcept
+        {
+            current = dfa->run(current, chunk.data(), chunk.data() + chunk.size());
+
+            return current != dead_state;
+        }
+
+        state_type state() const noexcept
+        {
+            return current;
+        }
+
+        /** Whether the symbols fed so far form an accepted word. */
+        bool accepting() const noexcept
+        {
+            return dfa->is_accepting(current);
+        }
+
+    private:
+        const CompiledDFA* dfa;
+        state_type current;
+    };
+
+    Cursor cursor() const noexcept
+    {
+        return Cursor{*this};
+    }
+
+    bool match(word_type word) const noexcept
+    {
+        return is_accepting(run(initial, word.data(), word.data() + word.size()));
+    }
+
+    /** Rule that accepts the whole word, no_rule if none does. */
+    rule_type classify(word_type word) const noexcept
+    {
+        auto cursor = this->cursor();
+        cursor.feed(word);
+        return rule(cursor.state());
+    }
+
+private:
+    /** Moves from state over the symbols in [p, end) and returns the last
+     * state, which is dead_state if the automaton got stuck.
+     */
+    state_type run(state_type state, const symbol_type* p, const symbol_type* end) const noexcept
+    {
+        if constexpr (is_byte_symbol_v<SymbolT>)
+        {
+            if (!loops.empty())
+            {
+                // Skipping only pays off once a self loop has been taken.
+                while (p != end && state != dead_state)
+                {
+                    state_type next = delta(state, *p++);
+
+                    if (next == state && end - p >= SelfLoop::block_size && loops[state].count != 0)
+                    {
+                        p = reinterpret_cast<const symbol_type*>(
+                            loops[state].skip(reinterpret_cast<const char*>(p), reinterpret_cast<const char*>(end)));
+                    }
+
+                    state = next;
+                }
+
+                return state;
+            }
+        }
+
+        for (; p != end && state != dead_state; ++p)
+        {
+            state = delta(state, *p);
+        }
+
+        return state;
+    }
+
+    columns_type columns;
+    size_t states_count = 0;
+    state_type initial = dead_state;
+    std::vector<state_type> table;
+    std::vector<std::uint64_t> accepting;
+    std::vector<rule_type> rules;
+    std::vector<SelfLoop> loops;
+};
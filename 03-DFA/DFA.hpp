@@ -1,10 +1,21 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <optional>
 #include <ostream>
+#include <string>
 #include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
+
+#include <Algebra.hpp>
+#include <AlphabetCompression.hpp>
+#include <CodeGenerator.hpp>
+#include <CompiledDFA.hpp>
+#include <Minimization.hpp>
+#include <Search.hpp>
 
 /** Unsafe implementation of a finite automaton. 
  * 
@@ -16,17 +27,19 @@ template <typename SymbolT, typename SymbolHash = std::hash<SymbolT>>
 class DFA
 {
 public:
-    using state_type  = std::string;
-    using symbol_type = SymbolT;
-    using pair_type   = std::pair<state_type, symbol_type>;
-    using result_type = std::pair<bool, state_type>;
-    using word_type   = std::basic_string_view<symbol_type>;
+    using state_type    = size_t;
+    using symbol_type   = SymbolT;
+    using pair_type     = std::pair<state_type, symbol_type>;
+    using result_type   = std::pair<bool, state_type>;
+    using word_type     = std::basic_string_view<symbol_type>;
+    using compiled_type = CompiledDFA<SymbolT, SymbolHash>;
+    using match_type    = typename Searcher<SymbolT, SymbolHash>::Match;
 
     struct PairHash
     {
         size_t operator () (const pair_type& p) const noexcept
         {
-            return std::hash<state_type>{}(p.first) ^ SymbolHash{}(p.second);
+            return std::hash<state_type>{}(p.first) * 31 ^ SymbolHash{}(p.second);
         }
     };
 
@@ -41,37 +54,54 @@ public:
 
     void set_initial_state(size_t state) noexcept
     {
-        initial_state = to_state(state);
+        initial_state = state;
     }
 
     void add_acceptation_state(size_t state)
     {
-        acceptation_state_set.insert(to_state(state));
+        acceptation_state_set.insert(state);
     }
 
     void add_acceptation_states(std::initializer_list<size_t> states)
     {
         for (auto state: states)
         {
-            acceptation_state_set.insert(to_state(state));
+            acceptation_state_set.insert(state);
         }
     }
 
     void add_transition(size_t state0, size_t state1, symbol_type symbol) noexcept
     {
-        auto s0 = to_state(state0);
-        auto s1 = to_state(state1);
-        state_set.emplace(s0);
-        state_set.emplace(s1);
-        transition_table.emplace(std::make_pair(s0, symbol), s1);
+        state_set.emplace(state0);
+        state_set.emplace(state1);
+        transition_table.emplace(std::make_pair(state0, symbol), state1);
+    }
+
+    bool match(word_type word) const noexcept
+    {
+        result_type result = ext_delta(initial_state, word);
+        return result.first &&
+            acceptation_state_set.find(result.second) != acceptation_state_set.end();
+    }
+
+    /** Leftmost-longest match in the text, starting at offset or after it.
+     *
+     * Builds a Searcher every time; keep one around to search many texts.
+     */
+    std::optional<match_type> search(word_type text, size_t offset = 0) const
+    {
+        auto compiled = compile();
+        return Searcher<SymbolT, SymbolHash>{compiled}.search(text, offset);
     }
 
-    bool match(word_type word) noexcept
+    /** Every leftmost-longest match in the text, without overlaps. */
+    std::vector<match_type> find_all(word_type text) const
     {
-        return ext_delta(initial_state, word).first;
+        auto compiled = compile();
+        return Searcher<SymbolT, SymbolHash>{compiled}.find_all(text);
     }
 
-    void to_dot(std::ostream& output) noexcept
+    void to_dot(std::ostream& output) const noexcept
     {
         output << "digraph\n{\n";
         
@@ -79,7 +109,7 @@ public:
 
         for (const auto& state: state_set)
         {
-            output << "  " << state << "[shape = ";
+            output << "  " << prefix << state << "[shape = ";
 
             if (acceptation_state_set.find(state) != acceptation_state_set.end())
             {
@@ -91,54 +121,178 @@ public:
 
         for (const auto& p: transition_table)
         {
-            output << "  " << p.first.first << " -> " << p.second  
+            output << "  " << prefix << p.first.first << " -> " << prefix << p.second
                    << "[label = \"" << p.first.second << "\"]\n";
         }
 
         output << "}";
     }
 
-private:
-    std::string to_state(size_t state) noexcept
+    /** Writes a direct-coded C++ matcher for this automaton, in the style
+     * of re2c. Only available for byte symbols.
+     */
+    void to_cpp(std::ostream& output, std::string_view function_name) const
     {
-        return prefix + std::to_string(state);
+        generate_cpp(minimize().compile(), output, function_name);
     }
 
-    result_type delta(const state_type& state, symbol_type symbol) noexcept
+    /** Builds the table-driven form of this automaton.
+     *
+     * The states are renumbered in increasing order of their numbers in
+     * the builder, so the compiled ids are contiguous. Byte automata get
+     * their alphabet compressed into equivalence classes.
+     */
+    compiled_type compile() const
     {
-        auto it = transition_table.find(std::make_pair(state, symbol));
+        std::vector<state_type> states{state_set.begin(), state_set.end()};
+        states.push_back(initial_state);
+        states.insert(states.end(), acceptation_state_set.begin(), acceptation_state_set.end());
+        std::sort(states.begin(), states.end());
+        states.erase(std::unique(states.begin(), states.end()), states.end());
 
-        if (it == transition_table.end())
+        std::unordered_map<state_type, typename compiled_type::state_type> ids;
+
+        for (const auto& state: states)
         {
-            return std::make_pair(false, "");
+            ids.emplace(state, ids.size());
         }
-        
-        return std::make_pair(true, it->second);
+
+        std::vector<symbol_type> symbols;
+
+        for (const auto& p: transition_table)
+        {
+            symbols.push_back(p.first.second);
+        }
+
+        compiled_type result{typename compiled_type::columns_type{symbols}, states.size(), ids[initial_state]};
+
+        for (const auto& p: transition_table)
+        {
+            auto column = result.symbol_columns().column(p.first.second);
+            result.set_transition(ids[p.first.first], column, ids[p.second]);
+        }
+
+        for (const auto& state: acceptation_state_set)
+        {
+            result.set_accepting(ids[state]);
+        }
+
+        if constexpr (is_byte_symbol_v<SymbolT>)
+        {
+            return compress_alphabet(result);
+        }
+        else
+        {
+            return result;
+        }
+    }
+
+    /** Returns the minimal DFA that accepts the same language.
+     *
+     * States of the result are numbered from 0, which is its initial state.
+     */
+    DFA minimize() const
+    {
+        return from_compiled(::minimize(compile()), prefix);
     }
 
-    result_type ext_delta(const state_type& state, word_type word)
+    /** Automaton of the words accepted by both automata. */
+    DFA intersect(const DFA& other) const
     {
-        if (word.size() == 0)
+        return from_compiled(::intersect(compile(), other.compile()), prefix);
+    }
+
+    /** Automaton of the words accepted by this one but not by the other. */
+    DFA difference(const DFA& other) const
+    {
+        return from_compiled(::difference(compile(), other.compile()), prefix);
+    }
+
+    /** Automaton of the words over the alphabet that this one rejects. */
+    DFA complement() const
+    {
+        return from_compiled(::complement(compile()), prefix);
+    }
+
+    /** Shortest word accepted by only one of the automata, if any. */
+    std::optional<std::vector<symbol_type>> counterexample(const DFA& other) const
+    {
+        return ::counterexample(compile(), other.compile());
+    }
+
+    bool equivalent(const DFA& other) const
+    {
+        return !counterexample(other);
+    }
+
+    /** Builds an automaton from its compiled form, keeping the state ids. */
+    static DFA from_compiled(const compiled_type& compiled, std::string_view state_prefix = "s")
+    {
+        DFA result{state_prefix};
+        result.set_initial_state(compiled.initial_state());
+
+        const auto& columns = compiled.symbol_columns();
+
+        for (typename compiled_type::state_type state = 0; state < compiled.num_states(); ++state)
         {
-            return std::make_pair(true, state);
+            result.state_set.insert(state);
+
+            for (typename compiled_type::column_type column = 0; column < compiled.num_columns(); ++column)
+            {
+                auto next = compiled.column_delta(state, column);
+
+                if (next != compiled_type::dead_state)
+                {
+                    columns.for_each_symbol(column, [&](const symbol_type& symbol)
+                    {
+                        result.add_transition(state, next, symbol);
+                    });
+                }
+            }
+
+            if (compiled.is_accepting(state))
+            {
+                result.add_acceptation_state(state);
+            }
         }
 
-        symbol_type symbol = word[word.size() - 1];
-        word_type remaining_word = word.substr(0, word.size() - 1);
+        return result;
+    }
 
-        result_type result = ext_delta(state, remaining_word);
+private:
+
+    result_type delta(state_type state, symbol_type symbol) const noexcept
+    {
+        auto it = transition_table.find(std::make_pair(state, symbol));
 
-        if (!result.first)
+        if (it == transition_table.end())
         {
-            return result;
+            return std::make_pair(false, state_type{});
+        }
+        
+        return std::make_pair(true, it->second);
+    }
+
+    result_type ext_delta(state_type state, word_type word) const noexcept
+    {
+        result_type result = std::make_pair(true, state);
+
+        for (const auto& symbol: word)
+        {
+            result = delta(result.second, symbol);
+
+            if (!result.first)
+            {
+                break;
+            }
         }
 
-        return delta(result.second, symbol);
+        return result;
     }
 
     state_set_type state_set;
     transition_table_type transition_table;
     state_set_type acceptation_state_set;
-    state_type initial_state = "s0";
+    state_type initial_state = 0;
     const std::string prefix;
 };
\ No newline at end of file
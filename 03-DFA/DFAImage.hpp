@@ -0,0 +1,346 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <CompiledDFA.hpp>
+
+/** Binary image of a compiled byte DFA.
+ *
+ * The file is the header followed by the payload, each section aligned to
+ * 8 bytes and stored in the byte order of the host:
+ *
+ *     uint8_t  class_map[256]
+ *     uint32_t table[states * columns]
+ *     uint64_t accepting[(states + 63) / 64]
+ *     uint32_t rules[states]
+ *
+ * The checksum is the 64-bit FNV-1a hash of the payload.
+ */
+struct DFAImageHeader
+{
+    static constexpr std::uint32_t magic_number = 0x31414644; // "DFA1"
+    static constexpr std::uint32_t current_version = 1;
+
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t states;
+    std::uint32_t columns;
+    std::uint32_t initial;
+    std::uint32_t reserved;
+    std::uint64_t payload_size;
+    std::uint64_t checksum;
+};
+
+/** Offsets of the payload sections, relative to the start of the payload. */
+struct DFAImageLayout
+{
+    size_t table;
+    size_t accepting;
+    size_t rules;
+    size_t size;
+
+    static constexpr size_t align(size_t offset) noexcept
+    {
+        return (offset + 7) & ~size_t{7};
+    }
+
+    static constexpr DFAImageLayout of(size_t states, size_t columns) noexcept
+    {
+        DFAImageLayout layout{};
+        layout.table = 256;
+        layout.accepting = align(layout.table + states * columns * sizeof(std::uint32_t));
+        layout.rules = layout.accepting + (states + 63) / 64 * sizeof(std::uint64_t);
+        layout.size = align(layout.rules + states * sizeof(std::uint32_t));
+        return layout;
+    }
+};
+
+inline std::uint64_t fnv1a(const void* data, size_t size) noexcept
+{
+    auto bytes = static_cast<const unsigned char*>(data);
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+/** Writes the image of a byte DFA, returns false if the file can not be
+ * written.
+ */
+template <typename SymbolT, typename SymbolHash>
+bool save_image(const CompiledDFA<SymbolT, SymbolHash>& dfa, const std::string& path)
+{
+    static_assert(is_byte_symbol_v<SymbolT>, "Only byte automata have a fixed image layout");
+
+    using dfa_type = CompiledDFA<SymbolT, SymbolHash>;
+
+    const size_t states = dfa.num_states();
+    const size_t columns = dfa.num_columns();
+    auto layout = DFAImageLayout::of(states, columns);
+    std::vector<unsigned char> payload(layout.size, 0);
+
+    const auto& class_map = dfa.symbol_columns().class_map();
+    std::memcpy(payload.data(), class_map.data(), class_map.size());
+
+    auto table = reinterpret_cast<std::uint32_t*>(payload.data() + layout.table);
+    auto accepting = reinterpret_cast<std::uint64_t*>(payload.data() + layout.accepting);
+    auto rules = reinterpret_cast<std::uint32_t*>(payload.data() + layout.rules);
+
+    for (typename dfa_type::state_type q = 0; q < states; ++q)
+    {
+        for (typename dfa_type::column_type c = 0; c < columns; ++c)
+        {
+            table[q * columns + c] = dfa.column_delta(q, c);
+        }
+
+        if (dfa.is_accepting(q))
+        {
+            accepting[q / 64] |= std::uint64_t{1} << (q % 64);
+        }
+
+        rules[q] = dfa.rule(q);
+    }
+
+    DFAImageHeader header{};
+    header.magic = DFAImageHeader::magic_number;
+    header.version = DFAImageHeader::current_version;
+    header.states = std::uint32_t(states);
+    header.columns = std::uint32_t(columns);
+    header.initial = dfa.initial_state();
+    header.payload_size = payload.size();
+    header.checksum = fnv1a(payload.data(), payload.size());
+
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+
+    return bool(out);
+}
+
+/** Byte DFA matched straight from a memory mapped image.
+ *
+ * Opening maps the file and checks the header, the size, unless told
+ * otherwise the checksum, and that every class and state in the tables is
+ * in range. The tables are then used in place: nothing is parsed or copied.
+ */
+class MappedDFA
+{
+public:
+    using state_type = std::uint32_t;
+    using rule_type  = std::uint32_t;
+    using word_type  = std::string_view;
+
+    static constexpr state_type dead_state = UINT32_MAX;
+    static constexpr rule_type no_rule = UINT32_MAX;
+
+    MappedDFA() = default;
+
+    MappedDFA(const MappedDFA&) = delete;
+
+    MappedDFA& operator = (const MappedDFA&) = delete;
+
+    MappedDFA(MappedDFA&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedDFA& operator = (MappedDFA&& other) noexcept
+    {
+        std::swap(mapping, other.mapping);
+        std::swap(mapping_size, other.mapping_size);
+        std::swap(header, other.header);
+        std::swap(class_map, other.class_map);
+        std::swap(table, other.table);
+        std::swap(accepting, other.accepting);
+        std::swap(rules, other.rules);
+        return *this;
+    }
+
+    ~MappedDFA() noexcept
+    {
+        close();
+    }
+
+    /** Maps an image, returns false if it can not be read or is not valid. */
+    bool open(const std::string& path, bool verify_checksum = true) noexcept
+    {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat info;
+
+        if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(DFAImageHeader))
+        {
+            ::close(fd);
+            return false;
+        }
+
+        void* address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (address == MAP_FAILED)
+        {
+            return false;
+        }
+
+        mapping = address;
+        mapping_size = info.st_size;
+        header = static_cast<const DFAImageHeader*>(mapping);
+
+        if (header->magic != DFAImageHeader::magic_number ||
+            header->version != DFAImageHeader::current_version ||
+            header->columns == 0 || header->columns > 256)
+        {
+            close();
+            return false;
+        }
+
+        auto layout = DFAImageLayout::of(header->states, header->columns);
+        auto payload = static_cast<const unsigned char*>(mapping) + sizeof(DFAImageHeader);
+
+        if (header->payload_size != layout.size || mapping_size != sizeof(DFAImageHeader) + layout.size ||
+            (verify_checksum && fnv1a(payload, layout.size) != header->checksum))
+        {
+            close();
+            return false;
+        }
+
+        class_map = payload;
+        table = reinterpret_cast<const std::uint32_t*>(payload + layout.table);
+        accepting = reinterpret_cast<const std::uint64_t*>(payload + layout.accepting);
+        rules = reinterpret_cast<const std::uint32_t*>(payload + layout.rules);
+
+        if (!has_valid_ranges())
+        {
+            close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void close() noexcept
+    {
+        if (mapping != nullptr)
+        {
+            munmap(mapping, mapping_size);
+        }
+
+        mapping = nullptr;
+        mapping_size = 0;
+        header = nullptr;
+    }
+
+    bool is_open() const noexcept
+    {
+        return mapping != nullptr;
+    }
+
+    state_type initial_state() const noexcept
+    {
+        return header->initial;
+    }
+
+    size_t num_states() const noexcept
+    {
+        return header->states;
+    }
+
+    state_type delta(state_type state, char symbol) const noexcept
+    {
+        return table[size_t(state) * header->columns + class_map[static_cast<unsigned char>(symbol)]];
+    }
+
+    bool is_accepting(state_type state) const noexcept
+    {
+        return state != dead_state && (accepting[state / 64] >> (state % 64)) & 1;
+    }
+
+    rule_type rule(state_type state) const noexcept
+    {
+        return state == dead_state ? no_rule : rules[state];
+    }
+
+    state_type run(word_type word) const noexcept
+    {
+        state_type state = header->initial;
+
+        for (size_t i = 0; i < word.size() && state != dead_state; ++i)
+        {
+            state = delta(state, word[i]);
+        }
+
+        return state;
+    }
+
+    bool match(word_type word) const noexcept
+    {
+        return is_accepting(run(word));
+    }
+
+    rule_type classify(word_type word) const noexcept
+    {
+        return rule(run(word));
+    }
+
+private:
+    /** Checks that every class and state in the tables is in range, so that
+     * matching never reads outside the mapping whatever the checksum says.
+     */
+    bool has_valid_ranges() const noexcept
+    {
+        const state_type states = header->states;
+        const size_t columns = header->columns;
+
+        if (header->initial >= states && header->initial != dead_state)
+        {
+            return false;
+        }
+
+        for (size_t c = 0; c < 256; ++c)
+        {
+            if (class_map[c] >= columns)
+            {
+                return false;
+            }
+        }
+
+        for (size_t i = 0, n = size_t(states) * columns; i < n; ++i)
+        {
+            if (table[i] >= states && table[i] != dead_state)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+    const DFAImageHeader* header = nullptr;
+    const unsigned char* class_map = nullptr;
+    const std::uint32_t* table = nullptr;
+    const std::uint64_t* accepting = nullptr;
+    const std::uint32_t* rules = nullptr;
+};
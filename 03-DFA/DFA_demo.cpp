@@ -5,53 +5,30 @@
 #include <unordered_set>
 #include <vector>
 
-#include <DFA.hpp>
-
-using fa_type = DFA<char>;
-
-void fill_range(char s0, char s1, int q0, int q1, fa_type& fa) noexcept
-{
-    for (char s = s0; s <= s1; ++s)
-    {
-        fa.add_transition(q0, q1, s);
-    }
-}
+#include <BatchClassifier.hpp>
+#include <DemoAutomata.hpp>
+#include <Tokenizer.hpp>
 
 int main(int argc, char* argv[])
 {
-    if (argc != 2)
+    bool batch = argc >= 4 && argc <= 5 && std::string_view{argv[1]} == "--batch";
+    bool binary = batch && argc == 5 && std::string_view{argv[4]} == "binary";
+    bool csv = batch && (argc == 4 || std::string_view{argv[4]} == "csv");
+
+    if (argc != 2 && !binary && !csv)
     {
-        std::cout << "Usage: " << argv[0] << " word\n";
+        std::cout << "Usage: " << argv[0] << " word\n"
+                  << "       " << argv[0] << " --batch words output [csv|binary]\n";
         return EXIT_FAILURE;
     }
 
     std::vector<std::string> dfa_names{"for", "identifier", "integer"};
 
-    std::vector<fa_type> automata(3);
-
-    // Create automata for RE for
-    automata[0].add_transition(0, 1, 'f');
-    automata[0].add_transition(1, 2, 'o');
-    automata[0].add_transition(2, 3, 'r');
-    automata[0].set_initial_state(0);
-    automata[0].add_acceptation_state(3);
-    
-    // Create automata for RE [a-z][a-z0-9]*
-    fill_range('a', 'z', 0, 1, automata[1]);
-    fill_range('a', 'z', 1, 2, automata[1]);
-    fill_range('0', '9', 1, 2, automata[1]);
-    fill_range('a', 'z', 2, 2, automata[1]);
-    fill_range('0', '9', 2, 2, automata[1]);
-    automata[1].set_initial_state(0);
-    automata[1].add_acceptation_states({1, 2});
-
-    // Create automata for RE ([1-9][0-9]*)|0
-    automata[2].add_transition(0, 3, '0');
-    fill_range('1', '9', 0, 1, automata[2]);
-    fill_range('0', '9', 1, 2, automata[2]);
-    fill_range('0', '9', 2, 2, automata[2]);
-    automata[2].set_initial_state(0);
-    automata[2].add_acceptation_states({1, 2, 3});
+    std::vector<fa_type> automata{
+        make_for_automaton(),
+        make_identifier_automaton(),
+        make_integer_automaton()
+    };
 
     for (size_t i = 0; i < automata.size(); ++i)
     {   
@@ -60,14 +37,57 @@ int main(int argc, char* argv[])
         out.close();
     }
 
-    for (size_t i = 0; i < automata.size(); ++i)
+    // Run all the automata in a single pass, the first one has priority
+    std::vector<fa_type::compiled_type> compiled;
+
+    for (const auto& automaton: automata)
+    {
+        compiled.push_back(automaton.compile());
+    }
+
+    auto all = minimize(unite(compiled));
+
+    if (batch)
     {
-        if (automata[i].match(argv[1]))
+        MappedFile input;
+
+        if (!input.open(argv[2]))
         {
-            std::cout << argv[1] << " matches with " << dfa_names[i] << std::endl;
-            return EXIT_SUCCESS;
+            std::cout << "Could not read " << argv[2] << std::endl;
+            return EXIT_FAILURE;
         }
+
+        auto rules = BatchClassifier<std::hash<char>>{all}.classify(input.view());
+
+        std::ofstream out{argv[3], std::ios::binary};
+
+        if (binary)
+        {
+            write_binary(rules, out);
+        }
+        else
+        {
+            write_csv(rules, out);
+        }
+
+        if (!out)
+        {
+            std::cout << "Could not write " << argv[3] << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::cout << "Classified " << rules.size() << " words" << std::endl;
+        return EXIT_SUCCESS;
     }
+
+    auto rule = all.classify(argv[1]);
+
+    if (rule != fa_type::compiled_type::no_rule)
+    {
+        std::cout << argv[1] << " matches with " << dfa_names[rule] << std::endl;
+        return EXIT_SUCCESS;
+    }
+
     
     std::cout << "Not match found for " << argv[1] << std::endl;
     
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <DFA.hpp>
+
+/** The automata of DFA_demo, shared by the demos and the benchmarks.
+ *
+ * They are built into any automaton type with set_initial_state,
+ * add_acceptation_state and add_transition, so the same definitions give
+ * a DFA<char> at run time and a StaticDFA in a constant expression.
+ */
+
+using fa_type = DFA<char>;
+
+template <typename FA>
+constexpr void fill_range(char s0, char s1, size_t q0, size_t q1, FA& fa) noexcept
+{
+    for (char s = s0; s <= s1; ++s)
+    {
+        fa.add_transition(q0, q1, s);
+    }
+}
+
+// Automaton for RE for
+template <typename FA = fa_type>
+constexpr FA make_for_automaton()
+{
+    FA fa;
+    fa.add_transition(0, 1, 'f');
+    fa.add_transition(1, 2, 'o');
+    fa.add_transition(2, 3, 'r');
+    fa.set_initial_state(0);
+    fa.add_acceptation_state(3);
+    return fa;
+}
+
+// Automaton for RE [a-z][a-z0-9]*
+template <typename FA = fa_type>
+constexpr FA make_identifier_automaton()
+{
+    FA fa;
+    fill_range('a', 'z', 0, 1, fa);
+    fill_range('a', 'z', 1, 2, fa);
+    fill_range('0', '9', 1, 2, fa);
+    fill_range('a', 'z', 2, 2, fa);
+    fill_range('0', '9', 2, 2, fa);
+    fa.set_initial_state(0);
+    fa.add_acceptation_state(1);
+    fa.add_acceptation_state(2);
+    return fa;
+}
+
+// Automaton for RE ([1-9][0-9]*)|0
+template <typename FA = fa_type>
+constexpr FA make_integer_automaton()
+{
+    FA fa;
+    fa.add_transition(0, 3, '0');
+    fill_range('1', '9', 0, 1, fa);
+    fill_range('0', '9', 1, 2, fa);
+    fill_range('0', '9', 2, 2, fa);
+    fa.set_initial_state(0);
+    fa.add_acceptation_state(1);
+    fa.add_acceptation_state(2);
+    fa.add_acceptation_state(3);
+    return fa;
+}
@@ -0,0 +1,519 @@
+#pragma once
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Minimization.hpp>
+#include <NFA.hpp>
+#include <Regex.hpp>
+#include <Tokenizer.hpp>
+
+/** Scanner loaded at run time from a flex specification.
+ *
+ * The definitions section may hold name definitions, which rules and
+ * later definitions use as {NAME}; code blocks and %options are skipped.
+ * Each rule is a pattern and an action. Patterns use the syntax of Regex
+ * plus quoted literals and {NAME}; an action that returns a name gives
+ * the token its name, any other action makes the rule skip its matches.
+ * The rules are united into a single automaton where, as in flex, the
+ * longest match wins and the earlier rule breaks ties. The user code
+ * section is ignored.
+ *
+ * Start conditions, anchors, trailing context and {n,m} repetitions are
+ * not supported; a specification that uses them fails to load.
+ */
+class FlexSpec
+{
+public:
+    using tokenizer_type = Tokenizer<char>;
+    using token_type     = tokenizer_type::Token;
+
+    struct Rule
+    {
+        std::string pattern;
+        std::string action;
+
+        /** Name returned by the action, empty for skipped matches. */
+        std::string token;
+    };
+
+    /** Loads a specification. On failure the result is empty and error,
+     * if given, tells why.
+     */
+    static std::optional<FlexSpec> load(std::string_view spec, std::string* error = nullptr)
+    {
+        FlexSpec result;
+        std::string message;
+
+        if (!result.read(spec, message) || !result.compile(message))
+        {
+            if (error != nullptr)
+            {
+                *error = message;
+            }
+
+            return std::nullopt;
+        }
+
+        return result;
+    }
+
+    static std::optional<FlexSpec> load_file(const std::string& path, std::string* error = nullptr)
+    {
+        std::ifstream in{path};
+
+        if (!in)
+        {
+            if (error != nullptr)
+            {
+                *error = "could not open " + path;
+            }
+
+            return std::nullopt;
+        }
+
+        std::stringstream content;
+        content << in.rdbuf();
+        return load(content.str(), error);
+    }
+
+    const std::vector<Rule>& rules() const noexcept
+    {
+        return rule_list;
+    }
+
+    const tokenizer_type& tokenizer() const noexcept
+    {
+        return *scanner;
+    }
+
+    /** Name of the token of a rule, "UNKNOWN" for input no rule matches. */
+    const std::string& name(tokenizer_type::rule_type rule) const noexcept
+    {
+        static const std::string unknown{"UNKNOWN"};
+        return rule == tokenizer_type::no_rule ? unknown : rule_list[rule].token;
+    }
+
+    /** Tokens of the buffer, without the matches of the skipping rules. */
+    std::vector<token_type> tokenize(std::string_view buffer) const
+    {
+        std::vector<token_type> tokens;
+
+        for (size_t offset = 0; offset < buffer.size();)
+        {
+            auto token = scanner->next(buffer, offset);
+            offset += token.length;
+
+            if (token.rule == tokenizer_type::no_rule || !rule_list[token.rule].token.empty())
+            {
+                tokens.push_back(token);
+            }
+        }
+
+        return tokens;
+    }
+
+private:
+    static bool is_name_start(char c) noexcept
+    {
+        return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    static bool is_name_char(char c) noexcept
+    {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-';
+    }
+
+    static std::string_view trim(std::string_view text) noexcept
+    {
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front())))
+        {
+            text.remove_prefix(1);
+        }
+
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back())))
+        {
+            text.remove_suffix(1);
+        }
+
+        return text;
+    }
+
+    /** Splits the specification into definitions and rules. */
+    bool read(std::string_view spec, std::string& error)
+    {
+        std::vector<std::string_view> lines;
+
+        for (size_t start = 0; start <= spec.size();)
+        {
+            size_t end = std::min(spec.find('\n', start), spec.size());
+            lines.push_back(spec.substr(start, end - start));
+            start = end + 1;
+        }
+
+        size_t i = 0;
+
+        // Definitions
+        for (bool code = false; i < lines.size() && lines[i].substr(0, 2) != "%%"; ++i)
+        {
+            auto line = lines[i];
+
+            if (line.substr(0, 2) == "%{" || line.substr(0, 2) == "%}")
+            {
+                code = line[1] == '{';
+                continue;
+            }
+
+            if (code || trim(line).empty() || !is_name_start(line[0]))
+            {
+                continue;
+            }
+
+            size_t name_end = 0;
+
+            while (name_end < line.size() && is_name_char(line[name_end]))
+            {
+                ++name_end;
+            }
+
+            std::string name{line.substr(0, name_end)};
+            auto regex = translate(trim(line.substr(name_end)), error);
+
+            if (!regex)
+            {
+                error = "definition " + name + ": " + error;
+                return false;
+            }
+
+            definitions[name] = *regex;
+        }
+
+        if (i == lines.size())
+        {
+            error = "missing %% before the rules";
+            return false;
+        }
+
+        // Rules, up to the user code
+        for (++i; i < lines.size() && lines[i].substr(0, 2) != "%%"; ++i)
+        {
+            auto line = lines[i];
+
+            // Indented lines and comments are code, not rules.
+            if (trim(line).empty() || std::isspace(static_cast<unsigned char>(line[0])) ||
+                line.substr(0, 2) == "/*")
+            {
+                continue;
+            }
+
+            size_t pattern_end = pattern_length(line);
+            Rule rule;
+            rule.pattern = std::string{line.substr(0, pattern_end)};
+            std::string action{trim(line.substr(pattern_end))};
+
+            // Actions in braces may go on for several lines.
+            while (depth(action) > 0 && i + 1 < lines.size())
+            {
+                action += '\n';
+                action += lines[++i];
+            }
+
+            rule.action = action;
+            rule.token = returned_name(action);
+            rule_list.push_back(std::move(rule));
+        }
+
+        // An action of | is the one of the next rule.
+        for (size_t r = rule_list.size(); r-- > 0;)
+        {
+            if (rule_list[r].action == "|" && r + 1 < rule_list.size())
+            {
+                rule_list[r].action = rule_list[r + 1].action;
+                rule_list[r].token = rule_list[r + 1].token;
+            }
+        }
+
+        return true;
+    }
+
+    /** Length of the pattern at the start of a rule line, which ends at
+     * the first blank outside quotes and classes.
+     */
+    static size_t pattern_length(std::string_view line) noexcept
+    {
+        bool quoted = false;
+
+        for (size_t i = 0; i < line.size(); ++i)
+        {
+            char c = line[i];
+
+            if (c == '\\')
+            {
+                ++i;
+            }
+            else if (quoted)
+            {
+                quoted = c != '"';
+            }
+            else if (c == '"')
+            {
+                quoted = true;
+            }
+            else if (c == '[')
+            {
+                i += class_length(line.substr(i)) - 1;
+            }
+            else if (std::isspace(static_cast<unsigned char>(c)))
+            {
+                return i;
+            }
+        }
+
+        return line.size();
+    }
+
+    /** Length of the class at the start of the text, brackets included. */
+    static size_t class_length(std::string_view text) noexcept
+    {
+        size_t i = 1;
+
+        if (i < text.size() && text[i] == '^')
+        {
+            ++i;
+        }
+
+        // A leading ] is a literal.
+        if (i < text.size() && text[i] == ']')
+        {
+            ++i;
+        }
+
+        for (; i < text.size() && text[i] != ']'; ++i)
+        {
+            if (text[i] == '\\')
+            {
+                ++i;
+            }
+        }
+
+        return std::min(i + 1, text.size());
+    }
+
+    /** Braces left open in an action, ignoring those in strings and
+     * character literals.
+     */
+    static int depth(std::string_view action) noexcept
+    {
+        int open = 0;
+        char quote = 0;
+
+        for (size_t i = 0; i < action.size(); ++i)
+        {
+            char c = action[i];
+
+            if (quote != 0)
+            {
+                if (c == '\\')
+                {
+                    ++i;
+                }
+                else if (c == quote)
+                {
+                    quote = 0;
+                }
+            }
+            else if (c == '"' || c == '\'')
+            {
+                quote = c;
+            }
+            else
+            {
+                open += (c == '{') - (c == '}');
+            }
+        }
+
+        return open;
+    }
+
+    /** The NAME of the first "return NAME" of an action. */
+    static std::string returned_name(std::string_view action)
+    {
+        for (size_t i = action.find("return"); i != std::string_view::npos; i = action.find("return", i + 1))
+        {
+            bool whole = (i == 0 || !is_name_char(action[i - 1])) &&
+                         i + 6 < action.size() && !is_name_char(action[i + 6]);
+
+            if (!whole)
+            {
+                continue;
+            }
+
+            auto rest = trim(action.substr(i + 6));
+            size_t end = 0;
+
+            while (end < rest.size() && is_name_char(rest[end]))
+            {
+                ++end;
+            }
+
+            return std::string{rest.substr(0, end)};
+        }
+
+        return {};
+    }
+
+    /** Rewrites a flex pattern in the syntax of Regex. */
+    std::optional<std::string> translate(std::string_view pattern, std::string& error) const
+    {
+        std::string result;
+
+        auto literal = [&](unsigned char c)
+        {
+            if (std::isalnum(c))
+            {
+                result += char(c);
+                return;
+            }
+
+            char escaped[5];
+            std::snprintf(escaped, sizeof(escaped), "\\x%02x", c);
+            result += escaped;
+        };
+
+        for (size_t i = 0; i < pattern.size(); ++i)
+        {
+            char c = pattern[i];
+
+            switch (c)
+            {
+                case '"':
+                {
+                    for (++i; i < pattern.size() && pattern[i] != '"'; ++i)
+                    {
+                        if (pattern[i] != '\\' || i + 1 == pattern.size())
+                        {
+                            literal(pattern[i]);
+                            continue;
+                        }
+
+                        switch (pattern[++i])
+                        {
+                            case 'n': literal('\n'); break;
+                            case 't': literal('\t'); break;
+                            case 'r': literal('\r'); break;
+                            case 'f': literal('\f'); break;
+                            case 'v': literal('\v'); break;
+                            case '0': literal('\0'); break;
+                            default: literal(pattern[i]); break;
+                        }
+                    }
+
+                    if (i == pattern.size())
+                    {
+                        error = "unterminated string in " + std::string{pattern};
+                        return std::nullopt;
+                    }
+
+                    break;
+                }
+                case '{':
+                {
+                    size_t end = pattern.find('}', i);
+
+                    if (end == std::string_view::npos || i + 1 == end || !is_name_start(pattern[i + 1]))
+                    {
+                        error = "repetitions are not supported in " + std::string{pattern};
+                        return std::nullopt;
+                    }
+
+                    auto it = definitions.find(std::string{pattern.substr(i + 1, end - i - 1)});
+
+                    if (it == definitions.end())
+                    {
+                        error = "undefined name in " + std::string{pattern};
+                        return std::nullopt;
+                    }
+
+                    result += "(?:" + it->second + ')';
+                    i = end;
+                    break;
+                }
+                case '\\':
+                {
+                    result += c;
+
+                    if (i + 1 < pattern.size())
+                    {
+                        result += pattern[++i];
+                    }
+
+                    break;
+                }
+                case '[':
+                {
+                    // Classes are the same in both syntaxes.
+                    size_t length = class_length(pattern.substr(i));
+                    result += pattern.substr(i, length);
+                    i += length - 1;
+                    break;
+                }
+                case '^': case '$': case '/': case '<':
+                {
+                    error = "anchors, trailing context and start conditions are not supported in " +
+                            std::string{pattern};
+                    return std::nullopt;
+                }
+                default:
+                    result += c;
+            }
+        }
+
+        return result;
+    }
+
+    /** Compiles every rule and unites them. */
+    bool compile(std::string& error)
+    {
+        std::vector<CompiledDFA<char>> automata;
+
+        for (const auto& rule: rule_list)
+        {
+            auto translated = translate(rule.pattern, error);
+
+            if (!translated)
+            {
+                return false;
+            }
+
+            auto regex = Regex::parse(*translated);
+
+            if (!regex)
+            {
+                error = "malformed pattern " + rule.pattern;
+                return false;
+            }
+
+            automata.push_back(minimize(NFA{*regex}.to_dfa()));
+        }
+
+        if (automata.empty())
+        {
+            error = "no rules";
+            return false;
+        }
+
+        scanner.emplace(minimize(unite(automata)));
+        return true;
+    }
+
+    std::map<std::string, std::string> definitions;
+    std::vector<Rule> rule_list;
+    std::optional<tokenizer_type> scanner;
+};
@@ -0,0 +1,335 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string_view>
+#include <vector>
+
+#include <NFA.hpp>
+
+/** DFA built from an NFA on demand, as in RE2.
+ *
+ * A DFA state is made the first time a match reaches it, and a transition
+ * the first time it is taken. The states live in a cache whose memory is
+ * bounded by a budget: when adding a state would go past it, the whole
+ * cache is flushed and built again from the current state. If flushes come
+ * too often for the cache to pay off, the rest of the word is matched by
+ * simulating the NFA, which needs no memory beyond the NFA itself.
+ */
+class LazyDFA
+{
+public:
+    using state_type     = std::uint32_t;
+    using state_set_type = NFA::state_set_type;
+    using word_type      = std::string_view;
+
+    static constexpr size_t default_budget = 1 << 20;
+
+    /** A flush is thrashing when fewer than this many bytes per cached
+     * state were matched since the previous one.
+     */
+    static constexpr size_t thrash_factor = 10;
+
+    LazyDFA(NFA _nfa, size_t _budget = default_budget)
+        : nfa{std::move(_nfa)}, budget{_budget}, marks(nfa.size(), 0)
+    {
+        // Bytes that no NFA transition tells apart share a column.
+        columns = 1;
+
+        for (state_type s = 0; s < nfa.size(); ++s)
+        {
+            const auto& state = nfa.state(s);
+
+            if (state.next == NFA::none)
+            {
+                continue;
+            }
+
+            std::vector<std::uint8_t> split(size_t(columns) * 2, 0);
+            std::vector<std::uint8_t> renumber(size_t(columns) * 2, 0);
+            unsigned count = 0;
+
+            for (size_t symbol = 0; symbol < 256; ++symbol)
+            {
+                size_t k = size_t(class_map[symbol]) * 2 + state.symbols.test(symbol);
+
+                if (!split[k])
+                {
+                    split[k] = 1;
+                    renumber[k] = std::uint8_t(count++);
+                }
+
+                class_map[symbol] = renumber[k];
+            }
+
+            columns = count;
+        }
+
+        for (size_t symbol = 0; symbol < 256; ++symbol)
+        {
+            if (symbols[class_map[symbol]] == 0 && class_map[symbol] != 0)
+            {
+                symbols[class_map[symbol]] = std::uint8_t(symbol);
+            }
+        }
+    }
+
+    bool match(word_type word)
+    {
+        state_type state = start_state();
+        size_t since_flush = 0;
+
+        for (size_t i = 0; i < word.size(); ++i, ++since_flush)
+        {
+            if (state == dead_state)
+            {
+                return false;
+            }
+
+            if (state == thrashing)
+            {
+                ++fallback_count;
+                return simulate(std::move(thrash_set), word.substr(i));
+            }
+
+            unsigned column = class_map[static_cast<unsigned char>(word[i])];
+            state_type next = table[size_t(state) * columns + column];
+
+            if (next == unknown)
+            {
+                size_t before = flush_count;
+                size_t cached = keys.size();
+                next = step(state, column);
+
+                if (flush_count != before && since_flush < thrash_factor * cached)
+                {
+                    state = next == dead_state ? dead_state : thrash(next);
+                    since_flush = 0;
+                    continue;
+                }
+
+                if (flush_count != before)
+                {
+                    since_flush = 0;
+                }
+            }
+
+            state = next;
+        }
+
+        if (state == thrashing)
+        {
+            ++fallback_count;
+            return simulate(std::move(thrash_set), {});
+        }
+
+        return state != dead_state && accepting[state];
+    }
+
+    /** Drops every cached state. */
+    void flush() noexcept
+    {
+        ids.clear();
+        keys.clear();
+        accepting.clear();
+        table.clear();
+        used = 0;
+        ++flush_count;
+    }
+
+    /** Number of states in the cache. */
+    size_t num_states() const noexcept
+    {
+        return keys.size();
+    }
+
+    /** Approximate memory used by the cache, in bytes. */
+    size_t memory() const noexcept
+    {
+        return used;
+    }
+
+    size_t flushes() const noexcept
+    {
+        return flush_count;
+    }
+
+    /** Number of matches finished by simulating the NFA. */
+    size_t fallbacks() const noexcept
+    {
+        return fallback_count;
+    }
+
+private:
+    static constexpr state_type dead_state = UINT32_MAX;
+    static constexpr state_type unknown = UINT32_MAX - 1;
+    static constexpr state_type thrashing = UINT32_MAX - 2;
+
+    /** Cost of a cached state besides its key, mostly the map node. */
+    static constexpr size_t state_overhead = 96;
+
+    state_type start_state()
+    {
+        state_set_type set{nfa.initial_state()};
+        nfa.closure(set, marks, ++generation);
+        auto start = key(set);
+
+        if (cost(start) > budget)
+        {
+            thrash_set = std::move(start);
+            return thrashing;
+        }
+
+        return add(std::move(start));
+    }
+
+    /** Important states of a closed set, sorted. */
+    state_set_type key(const state_set_type& set) const
+    {
+        state_set_type result;
+
+        for (auto s: set)
+        {
+            if (nfa.state(s).next != NFA::none || s == nfa.acceptation_state())
+            {
+                result.push_back(s);
+            }
+        }
+
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    /** Closed set of states reached from the set on the symbol. */
+    void advance(const state_set_type& set, std::uint8_t symbol, state_set_type& next)
+    {
+        next.clear();
+
+        for (auto s: set)
+        {
+            const auto& state = nfa.state(s);
+
+            if (state.next != NFA::none && state.symbols.test(symbol))
+            {
+                next.push_back(state.next);
+            }
+        }
+
+        nfa.closure(next, marks, ++generation);
+    }
+
+    /** Builds the transition of the state on a column, flushing the cache
+     * if the target does not fit in it.
+     */
+    state_type step(state_type state, unsigned column)
+    {
+        advance(*keys[state], symbols[column], buffer);
+        auto target = key(buffer);
+
+        if (target.empty())
+        {
+            table[size_t(state) * columns + column] = dead_state;
+            return dead_state;
+        }
+
+        auto it = ids.find(target);
+
+        if (it != ids.end())
+        {
+            table[size_t(state) * columns + column] = it->second;
+            return it->second;
+        }
+
+        if (used + cost(target) > budget)
+        {
+            flush();
+
+            if (cost(target) > budget)
+            {
+                thrash_set = std::move(target);
+                return thrashing;
+            }
+
+            return add(std::move(target));
+        }
+
+        state_type next = add(std::move(target));
+        table[size_t(state) * columns + column] = next;
+        return next;
+    }
+
+    /** Leaves the cache alone from now on: the rest of the word is matched
+     * by simulating the NFA from the state.
+     */
+    state_type thrash(state_type state)
+    {
+        if (state != thrashing)
+        {
+            thrash_set = *keys[state];
+        }
+
+        return thrashing;
+    }
+
+    size_t cost(const state_set_type& key) const noexcept
+    {
+        return state_overhead + key.size() * sizeof(state_type) + columns * sizeof(state_type);
+    }
+
+    state_type add(state_set_type key)
+    {
+        auto it = ids.find(key);
+
+        if (it != ids.end())
+        {
+            return it->second;
+        }
+
+        if (used + cost(key) > budget)
+        {
+            flush();
+        }
+
+        used += cost(key);
+        auto id = state_type(keys.size());
+        bool accepts = std::binary_search(key.begin(), key.end(), nfa.acceptation_state());
+        keys.push_back(&ids.emplace(std::move(key), id).first->first);
+        accepting.push_back(accepts);
+        table.resize(table.size() + columns, unknown);
+
+        return id;
+    }
+
+    bool simulate(state_set_type set, word_type word)
+    {
+        for (size_t i = 0; i < word.size() && !set.empty(); ++i)
+        {
+            advance(set, static_cast<std::uint8_t>(word[i]), buffer);
+            set.swap(buffer);
+        }
+
+        return std::find(set.begin(), set.end(), nfa.acceptation_state()) != set.end();
+    }
+
+    NFA nfa;
+    size_t budget;
+    std::vector<std::uint32_t> marks;
+    std::uint32_t generation = 0;
+    state_set_type buffer;
+
+    std::array<std::uint8_t, 256> class_map{};
+    std::array<std::uint8_t, 256> symbols{};
+    unsigned columns;
+
+    std::map<state_set_type, state_type> ids;
+    std::vector<const state_set_type*> keys;
+    std::vector<bool> accepting;
+    std::vector<state_type> table;
+    size_t used = 0;
+
+    state_set_type thrash_set;
+    size_t flush_count = 0;
+    size_t fallback_count = 0;
+};
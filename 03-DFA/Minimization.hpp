@@ -0,0 +1,292 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <CompiledDFA.hpp>
+
+/** Hopcroft's O(n log n) minimization of a compiled DFA.
+ *
+ * Unreachable states are dropped first and the missing transitions are
+ * treated as going to an explicit dead state, so that the automaton is
+ * complete while the partition is refined. States that accept different
+ * rules are never merged. The block of the dead state
+ * is dropped again from the result, whose states are numbered in
+ * breadth-first order from the initial state. Byte automata come out
+ * accelerated.
+ */
+template <typename SymbolT, typename SymbolHash>
+CompiledDFA<SymbolT, SymbolHash> minimize(const CompiledDFA<SymbolT, SymbolHash>& dfa)
+{
+    using dfa_type   = CompiledDFA<SymbolT, SymbolHash>;
+    using state_type = typename dfa_type::state_type;
+    using index_type = std::uint32_t;
+
+    const index_type columns = dfa.num_columns();
+
+    // Reachable states, renumbered from 0 with the dead state last.
+    std::vector<index_type> reachable(dfa.num_states(), dfa_type::dead_state);
+    std::vector<state_type> states;
+
+    if (dfa.initial_state() != dfa_type::dead_state)
+    {
+        reachable[dfa.initial_state()] = 0;
+        states.push_back(dfa.initial_state());
+    }
+
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+        for (index_type c = 0; c < columns; ++c)
+        {
+            state_type next = dfa.column_delta(states[i], c);
+
+            if (next != dfa_type::dead_state && reachable[next] == dfa_type::dead_state)
+            {
+                reachable[next] = index_type(states.size());
+                states.push_back(next);
+            }
+        }
+    }
+
+    const index_type dead = index_type(states.size());
+    const index_type n = dead + 1;
+
+    auto target = [&](index_type s, index_type c) -> index_type
+    {
+        if (s == dead)
+        {
+            return dead;
+        }
+
+        state_type next = dfa.column_delta(states[s], c);
+        return next == dfa_type::dead_state ? dead : reachable[next];
+    };
+
+    // Inverse transitions in compressed rows: sources of (column, target).
+    std::vector<index_type> inverse_begin(size_t(columns) * n + 1, 0);
+    std::vector<index_type> inverse(size_t(columns) * n);
+
+    for (index_type s = 0; s < n; ++s)
+    {
+        for (index_type c = 0; c < columns; ++c)
+        {
+            ++inverse_begin[size_t(c) * n + target(s, c) + 1];
+        }
+    }
+
+    for (size_t i = 1; i < inverse_begin.size(); ++i)
+    {
+        inverse_begin[i] += inverse_begin[i - 1];
+    }
+
+    {
+        std::vector<index_type> fill{inverse_begin.begin(), inverse_begin.end() - 1};
+
+        for (index_type s = 0; s < n; ++s)
+        {
+            for (index_type c = 0; c < columns; ++c)
+            {
+                inverse[fill[size_t(c) * n + target(s, c)]++] = s;
+            }
+        }
+    }
+
+    // Refinable partition: the states of block b are
+    // elements[first[b] .. past[b]), with the marked ones at the front.
+    std::vector<index_type> elements(n), location(n), block_of(n, 0);
+    std::vector<index_type> first, past, marked;
+
+    // The initial partition groups the states by the rule they accept;
+    // the states that accept nothing, the dead one among them, share a block.
+    auto rule = [&](index_type s)
+    {
+        return s == dead ? dfa_type::no_rule : dfa.rule(states[s]);
+    };
+
+    for (index_type s = 0; s < n; ++s)
+    {
+        elements[s] = s;
+    }
+
+    std::stable_sort(elements.begin(), elements.end(),
+                     [&](index_type a, index_type b) { return rule(a) < rule(b); });
+
+    auto add_block = [&](index_type begin, index_type end)
+    {
+        first.push_back(begin);
+        past.push_back(end);
+        marked.push_back(0);
+        return index_type(first.size() - 1);
+    };
+
+    for (index_type begin = 0, end = 0; begin < n; begin = end)
+    {
+        while (end < n && rule(elements[end]) == rule(elements[begin]))
+        {
+            ++end;
+        }
+
+        add_block(begin, end);
+    }
+
+    for (index_type b = 0; b < first.size(); ++b)
+    {
+        for (index_type i = first[b]; i < past[b]; ++i)
+        {
+            block_of[elements[i]] = b;
+            location[elements[i]] = i;
+        }
+    }
+
+    // Pending splitters (block, column), with a flag per pair to know
+    // which ones are already waiting.
+    std::vector<std::pair<index_type, index_type>> pending;
+    std::vector<bool> waiting(size_t(n) * columns, false);
+
+    auto push = [&](index_type b, index_type c)
+    {
+        waiting[size_t(b) * columns + c] = true;
+        pending.emplace_back(b, c);
+    };
+
+    // Every initial block but the largest one is a splitter.
+    index_type largest = 0;
+
+    for (index_type b = 1; b < first.size(); ++b)
+    {
+        if (past[b] - first[b] > past[largest] - first[largest])
+        {
+            largest = b;
+        }
+    }
+
+    for (index_type b = 0; b < first.size(); ++b)
+    {
+        for (index_type c = 0; b != largest && c < columns; ++c)
+        {
+            push(b, c);
+        }
+    }
+
+    std::vector<index_type> splitter, touched;
+
+    while (!pending.empty())
+    {
+        auto [b, c] = pending.back();
+        pending.pop_back();
+        waiting[size_t(b) * columns + c] = false;
+
+        splitter.assign(elements.begin() + first[b], elements.begin() + past[b]);
+
+        for (auto t: splitter)
+        {
+            for (index_type i = inverse_begin[size_t(c) * n + t]; i < inverse_begin[size_t(c) * n + t + 1]; ++i)
+            {
+                index_type s = inverse[i];
+                index_type sb = block_of[s];
+                index_type position = first[sb] + marked[sb];
+
+                if (location[s] < position)
+                {
+                    continue;
+                }
+
+                if (marked[sb] == 0)
+                {
+                    touched.push_back(sb);
+                }
+
+                index_type other = elements[position];
+                std::swap(elements[location[s]], elements[position]);
+                location[other] = location[s];
+                location[s] = position;
+                ++marked[sb];
+            }
+        }
+
+        for (auto sb: touched)
+        {
+            index_type count = marked[sb];
+            marked[sb] = 0;
+
+            if (count == past[sb] - first[sb])
+            {
+                continue;
+            }
+
+            index_type nb = add_block(first[sb], first[sb] + count);
+            first[sb] += count;
+
+            for (index_type i = first[nb]; i < past[nb]; ++i)
+            {
+                block_of[elements[i]] = nb;
+            }
+
+            index_type smaller = past[nb] - first[nb] <= past[sb] - first[sb] ? nb : sb;
+
+            for (index_type a = 0; a < columns; ++a)
+            {
+                push(waiting[size_t(sb) * columns + a] ? nb : smaller, a);
+            }
+        }
+
+        touched.clear();
+    }
+
+    // Blocks become the new states, the block of the dead state is dropped.
+    const index_type dead_block = block_of[dead];
+    std::vector<index_type> number(first.size(), dfa_type::dead_state);
+    std::vector<index_type> representatives;
+
+    if (block_of[0] != dead_block && dead > 0)
+    {
+        number[block_of[0]] = 0;
+        representatives.push_back(0);
+    }
+
+    for (size_t i = 0; i < representatives.size(); ++i)
+    {
+        for (index_type c = 0; c < columns; ++c)
+        {
+            index_type nb = block_of[target(representatives[i], c)];
+
+            if (nb != dead_block && number[nb] == dfa_type::dead_state)
+            {
+                number[nb] = index_type(representatives.size());
+                representatives.push_back(elements[first[nb]]);
+            }
+        }
+    }
+
+    if (representatives.empty())
+    {
+        return dfa_type{dfa.symbol_columns(), 1, 0};
+    }
+
+    dfa_type result{dfa.symbol_columns(), representatives.size(), 0};
+
+    for (index_type q = 0; q < representatives.size(); ++q)
+    {
+        index_type s = representatives[q];
+
+        for (index_type c = 0; c < columns; ++c)
+        {
+            index_type nb = block_of[target(s, c)];
+
+            if (nb != dead_block)
+            {
+                result.set_transition(q, c, number[nb]);
+            }
+        }
+
+        if (dfa.is_accepting(states[s]))
+        {
+            result.set_accepting(q, dfa.rule(states[s]));
+        }
+    }
+
+    result.accelerate();
+
+    return result;
+}
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <AlphabetCompression.hpp>
+#include <CompiledDFA.hpp>
+#include <Regex.hpp>
+
+/** Thompson NFA over bytes.
+ *
+ * Every state has at most two epsilon transitions and at most one
+ * transition labeled by a set of bytes. There is a single acceptation
+ * state. Capture group g is entered through a state tagged 2g and left
+ * through one tagged 2g + 1; the tags only matter to TaggedDFA.
+ */
+class NFA
+{
+public:
+    using state_type = std::uint32_t;
+    using state_set_type = std::vector<state_type>;
+    using compiled_type = CompiledDFA<char>;
+
+    static constexpr state_type none = UINT32_MAX;
+
+    struct State
+    {
+        ByteSet symbols;
+        state_type next = none;
+        state_type epsilon[2] = {none, none};
+        std::uint32_t tag = none;
+    };
+
+    NFA() = default;
+
+    /** Thompson's construction. */
+    NFA(const Regex& regex)
+    {
+        auto fragment = build(regex, regex.root());
+        start = fragment.first;
+        accept = fragment.second;
+    }
+
+    state_type initial_state() const noexcept
+    {
+        return start;
+    }
+
+    state_type acceptation_state() const noexcept
+    {
+        return accept;
+    }
+
+    size_t size() const noexcept
+    {
+        return states.size();
+    }
+
+    const State& state(state_type s) const noexcept
+    {
+        return states[s];
+    }
+
+    /** Adds to the set every state reachable through epsilon transitions.
+     *
+     * The set keeps the order in which states are first reached, in a
+     * depth-first walk that follows epsilon[0] before epsilon[1].
+     * The marks vector must have one entry per state; entries equal to
+     * generation are taken as already in the set.
+     */
+    void closure(state_set_type& set, std::vector<std::uint32_t>& marks, std::uint32_t generation) const
+    {
+        std::vector<state_type> stack;
+
+        for (auto it = set.rbegin(); it != set.rend(); ++it)
+        {
+            stack.push_back(*it);
+        }
+
+        set.clear();
+
+        while (!stack.empty())
+        {
+            state_type s = stack.back();
+            stack.pop_back();
+
+            if (s == none || marks[s] == generation)
+            {
+                continue;
+            }
+
+            marks[s] = generation;
+            set.push_back(s);
+            stack.push_back(states[s].epsilon[1]);
+            stack.push_back(states[s].epsilon[0]);
+        }
+    }
+
+    /** Subset construction.
+     *
+     * Only the states with byte transitions and the acceptation state tell
+     * two subsets apart, so the DFA states are keyed by those. The result
+     * has its alphabet compressed.
+     */
+    compiled_type to_dfa() const
+    {
+        std::vector<std::uint32_t> marks(states.size(), 0);
+        std::uint32_t generation = 0;
+
+        auto key = [&](state_set_type set)
+        {
+            state_set_type result;
+
+            for (auto s: set)
+            {
+                if (states[s].next != none || s == accept)
+                {
+                    result.push_back(s);
+                }
+            }
+
+            std::sort(result.begin(), result.end());
+            return result;
+        };
+
+        std::map<state_set_type, compiled_type::state_type> ids;
+        std::vector<state_set_type> subsets;
+        std::vector<compiled_type::state_type> rows;
+
+        auto add = [&](state_set_type set)
+        {
+            closure(set, marks, ++generation);
+            auto k = key(set);
+            auto [it, inserted] = ids.emplace(k, compiled_type::state_type(subsets.size()));
+
+            if (inserted)
+            {
+                subsets.push_back(std::move(k));
+            }
+
+            return it->second;
+        };
+
+        add({start});
+
+        std::vector<state_set_type> buckets(256);
+        std::map<state_set_type, compiled_type::state_type> targets;
+
+        for (size_t i = 0; i < subsets.size(); ++i)
+        {
+            for (auto& bucket: buckets)
+            {
+                bucket.clear();
+            }
+
+            for (auto s: subsets[i])
+            {
+                const State& state = states[s];
+
+                for (size_t symbol = 0; state.next != none && symbol < 256; ++symbol)
+                {
+                    if (state.symbols.test(symbol))
+                    {
+                        buckets[symbol].push_back(state.next);
+                    }
+                }
+            }
+
+            // Many bytes usually lead to the same subset.
+            targets.clear();
+            rows.resize((i + 1) * 256, compiled_type::dead_state);
+
+            for (size_t symbol = 0; symbol < 256; ++symbol)
+            {
+                if (buckets[symbol].empty())
+                {
+                    continue;
+                }
+
+                auto it = targets.find(buckets[symbol]);
+
+                if (it == targets.end())
+                {
+                    it = targets.emplace(buckets[symbol], add(buckets[symbol])).first;
+                }
+
+                rows[i * 256 + symbol] = it->second;
+            }
+        }
+
+        compiled_type result{compiled_type::columns_type{}, subsets.size(), 0};
+
+        for (compiled_type::state_type q = 0; q < subsets.size(); ++q)
+        {
+            for (compiled_type::column_type symbol = 0; symbol < 256; ++symbol)
+            {
+                result.set_transition(q, symbol, rows[size_t(q) * 256 + symbol]);
+            }
+
+            if (std::binary_search(subsets[q].begin(), subsets[q].end(), accept))
+            {
+                result.set_accepting(q);
+            }
+        }
+
+        return compress_alphabet(result);
+    }
+
+private:
+    using fragment_type = std::pair<state_type, state_type>;
+
+    state_type add_state()
+    {
+        states.emplace_back();
+        return state_type(states.size() - 1);
+    }
+
+    void add_epsilon(state_type from, state_type to) noexcept
+    {
+        State& state = states[from];
+        state.epsilon[state.epsilon[0] == none ? 0 : 1] = to;
+    }
+
+    fragment_type build(const Regex& regex, Regex::index_type index)
+    {
+        const RegexNode& node = regex.node(index);
+
+        switch (node.kind)
+        {
+            case RegexNode::Kind::Empty:
+            {
+                state_type s = add_state();
+                return {s, s};
+            }
+            case RegexNode::Kind::Symbols:
+            {
+                state_type s = add_state();
+                state_type e = add_state();
+                states[s].symbols = node.symbols;
+                states[s].next = e;
+                return {s, e};
+            }
+            case RegexNode::Kind::Concatenation:
+            {
+                auto left = build(regex, node.left);
+                auto right = build(regex, node.right);
+                add_epsilon(left.second, right.first);
+                return {left.first, right.second};
+            }
+            case RegexNode::Kind::Alternation:
+            {
+                auto left = build(regex, node.left);
+                auto right = build(regex, node.right);
+                state_type s = add_state();
+                state_type e = add_state();
+                add_epsilon(s, left.first);
+                add_epsilon(s, right.first);
+                add_epsilon(left.second, e);
+                add_epsilon(right.second, e);
+                return {s, e};
+            }
+            case RegexNode::Kind::Star:
+            {
+                auto inner = build(regex, node.left);
+                state_type s = add_state();
+                state_type e = add_state();
+                add_epsilon(s, inner.first);
+                add_epsilon(s, e);
+                add_epsilon(inner.second, inner.first);
+                add_epsilon(inner.second, e);
+                return {s, e};
+            }
+            case RegexNode::Kind::Plus:
+            {
+                auto inner = build(regex, node.left);
+                state_type e = add_state();
+                add_epsilon(inner.second, inner.first);
+                add_epsilon(inner.second, e);
+                return {inner.first, e};
+            }
+            case RegexNode::Kind::Optional:
+            {
+                auto inner = build(regex, node.left);
+                state_type s = add_state();
+                state_type e = add_state();
+                add_epsilon(s, inner.first);
+                add_epsilon(s, e);
+                add_epsilon(inner.second, e);
+                return {s, e};
+            }
+            case RegexNode::Kind::Group:
+            {
+                auto inner = build(regex, node.left);
+                state_type s = add_state();
+                state_type e = add_state();
+                states[s].tag = 2 * node.group;
+                states[e].tag = 2 * node.group + 1;
+                add_epsilon(s, inner.first);
+                add_epsilon(inner.second, e);
+                return {s, e};
+            }
+        }
+
+        return {none, none};
+    }
+
+    std::vector<State> states;
+    state_type start = none;
+    state_type accept = none;
+};
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <CompiledDFA.hpp>
+
+/** Speculative parallel matching of a long word, after Mytkowicz, Musuvathi
+ * and Schulte, "Data-parallel finite-state machines".
+ *
+ * The word is split into chunks that worker threads take in turn. Since the
+ * state entering a chunk is not known yet, a chunk is run from every state
+ * it could start in. Those are the targets of the symbol that precedes
+ * the chunk, usually only a few. Runs that reach the same state are merged
+ * as the chunk goes on. Each chunk thus yields a mapping from start states
+ * to end states, and the mappings are composed in order at the end.
+ */
+template <typename SymbolT, typename SymbolHash>
+class ParallelMatcher
+{
+public:
+    using dfa_type    = CompiledDFA<SymbolT, SymbolHash>;
+    using state_type  = typename dfa_type::state_type;
+    using column_type = typename dfa_type::column_type;
+    using word_type   = typename dfa_type::word_type;
+
+    /** Words shorter than this are matched sequentially. */
+    static constexpr size_t min_chunk_size = 1 << 16;
+
+    ParallelMatcher(const dfa_type& _dfa, unsigned _threads = std::thread::hardware_concurrency()) noexcept
+        : dfa{_dfa}, threads{std::max(1u, _threads)}
+    {
+
+    }
+
+    bool match(word_type word) const
+    {
+        return dfa.is_accepting(run(word));
+    }
+
+    /** State reached from the initial state after the whole word. */
+    state_type run(word_type word) const
+    {
+        size_t chunks = std::min(size_t(threads) * 4, word.size() / min_chunk_size);
+
+        if (threads == 1 || chunks < 2)
+        {
+            return run_chunk(dfa.initial_state(), word);
+        }
+
+        size_t chunk_size = (word.size() + chunks - 1) / chunks;
+        std::vector<std::vector<state_type>> mappings(chunks);
+        state_type first_state = dfa_type::dead_state;
+        std::atomic<size_t> next_chunk{0};
+
+        auto worker = [&]()
+        {
+            for (size_t i = next_chunk++; i < chunks; i = next_chunk++)
+            {
+                word_type chunk = word.substr(i * chunk_size, chunk_size);
+
+                if (i == 0)
+                {
+                    first_state = run_chunk(dfa.initial_state(), chunk);
+                }
+                else
+                {
+                    mappings[i] = speculate(word[i * chunk_size - 1], chunk);
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+
+        for (unsigned t = 1; t < threads; ++t)
+        {
+            pool.emplace_back(worker);
+        }
+
+        worker();
+
+        for (auto& thread: pool)
+        {
+            thread.join();
+        }
+
+        state_type state = first_state;
+
+        for (size_t i = 1; i < chunks && state != dfa_type::dead_state; ++i)
+        {
+            state = mappings[i][state];
+        }
+
+        return state;
+    }
+
+private:
+    state_type run_chunk(state_type state, word_type chunk) const noexcept
+    {
+        typename dfa_type::Cursor cursor{dfa, state};
+        cursor.feed(chunk);
+        return cursor.state();
+    }
+
+    /** Maps every state the chunk can start in to the state it ends in.
+     *
+     * The other entries of the mapping are never read and stay dead.
+     */
+    std::vector<state_type> speculate(SymbolT previous, word_type chunk) const
+    {
+        // Merging runs costs a pass over the active states, so it is done
+        // every so many symbols.
+        constexpr size_t merge_period = 64;
+
+        const size_t n = dfa.num_states();
+        std::vector<state_type> starts;
+        std::vector<char> seen(n, 0);
+
+        for (state_type q = 0; q < n; ++q)
+        {
+            state_type s = dfa.delta(q, previous);
+
+            if (s != dfa_type::dead_state && !seen[s])
+            {
+                seen[s] = 1;
+                starts.push_back(s);
+            }
+        }
+
+        // active[slot[i]] is the current state of the run from starts[i].
+        std::vector<state_type> active{starts};
+        std::vector<size_t> slot(starts.size());
+        std::vector<size_t> remap(starts.size());
+        std::vector<size_t> merged_slot(n);
+        std::vector<size_t> stamp(n, 0);
+        size_t generation = 0;
+
+        for (size_t i = 0; i < slot.size(); ++i)
+        {
+            slot[i] = i;
+        }
+
+        const auto& columns = dfa.symbol_columns();
+
+        for (size_t position = 0; position < chunk.size() && !active.empty(); ++position)
+        {
+            column_type column = columns.column(chunk[position]);
+
+            for (auto& state: active)
+            {
+                state = state == dfa_type::dead_state || column == dfa_type::columns_type::no_column
+                    ? dfa_type::dead_state
+                    : dfa.column_delta(state, column);
+            }
+
+            if (position % merge_period != merge_period - 1)
+            {
+                continue;
+            }
+
+            // Runs in the same state from now on share a slot.
+            ++generation;
+            size_t kept = 0;
+
+            for (size_t j = 0; j < active.size(); ++j)
+            {
+                state_type state = active[j];
+
+                if (state == dfa_type::dead_state)
+                {
+                    remap[j] = SIZE_MAX;
+                    continue;
+                }
+
+                if (stamp[state] != generation)
+                {
+                    stamp[state] = generation;
+                    merged_slot[state] = kept;
+                    active[kept++] = state;
+                }
+
+                remap[j] = merged_slot[state];
+            }
+
+            active.resize(kept);
+
+            for (auto& s: slot)
+            {
+                s = s == SIZE_MAX ? SIZE_MAX : remap[s];
+            }
+        }
+
+        std::vector<state_type> mapping(n, dfa_type::dead_state);
+
+        for (size_t i = 0; i < starts.size(); ++i)
+        {
+            if (slot[i] != SIZE_MAX && slot[i] < active.size())
+            {
+                mapping[starts[i]] = active[slot[i]];
+            }
+        }
+
+        return mapping;
+    }
+
+    const dfa_type& dfa;
+    unsigned threads;
+};
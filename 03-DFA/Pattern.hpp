@@ -0,0 +1,76 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <BitParallelNFA.hpp>
+#include <CompiledDFA.hpp>
+#include <Minimization.hpp>
+#include <NFA.hpp>
+#include <Regex.hpp>
+#include <Search.hpp>
+
+/** Regular expression with the engine picked by its size.
+ *
+ * Expressions with at most BitParallelNFA::max_positions leaves run on
+ * the bit-parallel Glushkov automaton, which needs no DFA. Larger ones go
+ * through the subset construction and minimization to a table DFA.
+ */
+class Pattern
+{
+public:
+    using dfa_type      = CompiledDFA<char>;
+    using searcher_type = Searcher<char, std::hash<char>>;
+    using match_type    = searcher_type::Match;
+    using word_type     = std::string_view;
+
+    /** The result is empty when the pattern is malformed. */
+    static std::optional<Pattern> compile(std::string_view pattern)
+    {
+        auto regex = Regex::parse(pattern);
+
+        if (!regex)
+        {
+            return std::nullopt;
+        }
+
+        Pattern result;
+        result.bit_parallel = BitParallelNFA::build(*regex);
+
+        if (!result.bit_parallel)
+        {
+            // The searcher keeps a reference to the automaton.
+            result.dfa = std::make_unique<dfa_type>(minimize(NFA{*regex}.to_dfa()));
+            result.searcher = std::make_unique<searcher_type>(*result.dfa);
+        }
+
+        return result;
+    }
+
+    bool is_bit_parallel() const noexcept
+    {
+        return bit_parallel.has_value();
+    }
+
+    bool match(word_type word) const noexcept
+    {
+        return bit_parallel ? bit_parallel->match(word) : dfa->match(word);
+    }
+
+    std::optional<match_type> search(word_type text, size_t offset = 0) const noexcept
+    {
+        return bit_parallel ? bit_parallel->search(text, offset) : searcher->search(text, offset);
+    }
+
+    std::vector<match_type> find_all(word_type text) const
+    {
+        return bit_parallel ? bit_parallel->find_all(text) : searcher->find_all(text);
+    }
+
+private:
+    std::optional<BitParallelNFA> bit_parallel;
+    std::unique_ptr<dfa_type> dfa;
+    std::unique_ptr<searcher_type> searcher;
+};
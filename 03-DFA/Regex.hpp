@@ -0,0 +1,531 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <Utf8.hpp>
+
+/** Set of bytes used to label the leaves of a regular expression. */
+using ByteSet = std::bitset<256>;
+
+/** Node of the syntax tree of a regular expression.
+ *
+ * Nodes live in the array of their Regex and refer to their children by
+ * index: Concatenation and Alternation use left and right, the closures
+ * and Group only use left. A Group is a capture group around its child,
+ * numbered by its opening parenthesis from 1.
+ */
+struct RegexNode
+{
+    enum class Kind
+    {
+        Empty,
+        Symbols,
+        Concatenation,
+        Alternation,
+        Star,
+        Plus,
+        Optional,
+        Group
+    };
+
+    static constexpr std::uint32_t none = UINT32_MAX;
+
+    Kind kind;
+    ByteSet symbols;
+    std::uint32_t left = none;
+    std::uint32_t right = none;
+    std::uint32_t group = none;
+};
+
+/** Syntax tree of a regular expression over bytes.
+ *
+ * Supported syntax: concatenation, |, *, +, ?, parentheses, the dot (any
+ * byte but the newline), character classes with ranges and negation
+ * ([a-z0-9_], [^ab]) and the escapes \n, \t, \r, \f, \v, \0, \xHH and
+ * \c for any other character c. Parentheses capture, unless they are
+ * written (?:...).
+ *
+ * In UTF-8 mode the pattern is UTF-8 and its atoms are codepoints: the
+ * dot, the classes and \xHH, \uHHHH and \u{H...} stand for codepoints,
+ * and they are compiled into the byte sequences that encode them. The
+ * automaton stays over bytes and only accepts valid UTF-8 where a
+ * codepoint is expected.
+ */
+class Regex
+{
+public:
+    using node_type = RegexNode;
+    using index_type = std::uint32_t;
+
+    enum class Encoding
+    {
+        Bytes,
+        Utf8
+    };
+
+    /** Parses a pattern, the result is empty when the pattern is malformed. */
+    static std::optional<Regex> parse(std::string_view pattern, Encoding encoding = Encoding::Bytes) noexcept
+    {
+        Regex regex;
+        Parser parser{pattern, regex, encoding == Encoding::Utf8};
+        auto root = parser.parse_alternation();
+
+        if (!parser.ok || parser.position != pattern.size())
+        {
+            return std::nullopt;
+        }
+
+        regex.root_node = root;
+        return regex;
+    }
+
+    index_type root() const noexcept
+    {
+        return root_node;
+    }
+
+    const node_type& node(index_type index) const noexcept
+    {
+        return nodes[index];
+    }
+
+    size_t size() const noexcept
+    {
+        return nodes.size();
+    }
+
+    /** Number of capture groups. */
+    size_t groups() const noexcept
+    {
+        return group_count;
+    }
+
+    index_type add(node_type node)
+    {
+        nodes.push_back(node);
+        return index_type(nodes.size() - 1);
+    }
+
+    index_type add(node_type::Kind kind, index_type left = node_type::none, index_type right = node_type::none)
+    {
+        node_type node;
+        node.kind = kind;
+        node.left = left;
+        node.right = right;
+        return add(node);
+    }
+
+    index_type add(const ByteSet& symbols)
+    {
+        node_type node;
+        node.kind = node_type::Kind::Symbols;
+        node.symbols = symbols;
+        return add(node);
+    }
+
+    /** Alternation of the UTF-8 encodings of a set of codepoints. */
+    index_type add(const CodepointRanges& ranges)
+    {
+        std::vector<Utf8Sequence> sequences;
+
+        for (auto [first, last]: ranges)
+        {
+            utf8_sequences(first, last, sequences);
+        }
+
+        // The single bytes all go to one leaf.
+        ByteSet single;
+        index_type result = node_type::none;
+
+        auto alternative = [&](index_type node)
+        {
+            result = result == node_type::none ? node : add(node_type::Kind::Alternation, result, node);
+        };
+
+        for (const auto& sequence: sequences)
+        {
+            if (sequence.size() == 1)
+            {
+                for (unsigned byte = sequence[0].first; byte <= sequence[0].second; ++byte)
+                {
+                    single.set(byte);
+                }
+
+                continue;
+            }
+
+            index_type concatenation = node_type::none;
+
+            for (auto [low, high]: sequence)
+            {
+                ByteSet bytes;
+
+                for (unsigned byte = low; byte <= high; ++byte)
+                {
+                    bytes.set(byte);
+                }
+
+                index_type leaf = add(bytes);
+                concatenation = concatenation == node_type::none
+                    ? leaf
+                    : add(node_type::Kind::Concatenation, concatenation, leaf);
+            }
+
+            alternative(concatenation);
+        }
+
+        if (single.any() || result == node_type::none)
+        {
+            alternative(add(single));
+        }
+
+        return result;
+    }
+
+private:
+    struct Parser
+    {
+        std::string_view pattern;
+        Regex& regex;
+        bool utf8 = false;
+        size_t position = 0;
+        bool ok = true;
+
+        bool at_end() const noexcept
+        {
+            return position >= pattern.size();
+        }
+
+        char peek() const noexcept
+        {
+            return pattern[position];
+        }
+
+        index_type fail() noexcept
+        {
+            ok = false;
+            return node_type::none;
+        }
+
+        index_type parse_alternation()
+        {
+            index_type left = parse_concatenation();
+
+            while (ok && !at_end() && peek() == '|')
+            {
+                ++position;
+                index_type right = parse_concatenation();
+                left = regex.add(node_type::Kind::Alternation, left, right);
+            }
+
+            return left;
+        }
+
+        index_type parse_concatenation()
+        {
+            index_type left = node_type::none;
+
+            while (ok && !at_end() && peek() != '|' && peek() != ')')
+            {
+                index_type right = parse_repetition();
+                left = left == node_type::none ? right : regex.add(node_type::Kind::Concatenation, left, right);
+            }
+
+            return left == node_type::none ? regex.add(node_type::Kind::Empty) : left;
+        }
+
+        index_type parse_repetition()
+        {
+            index_type atom = parse_atom();
+
+            while (ok && !at_end())
+            {
+                switch (peek())
+                {
+                    case '*': atom = regex.add(node_type::Kind::Star, atom); break;
+                    case '+': atom = regex.add(node_type::Kind::Plus, atom); break;
+                    case '?': atom = regex.add(node_type::Kind::Optional, atom); break;
+                    default: return atom;
+                }
+
+                ++position;
+            }
+
+            return atom;
+        }
+
+        index_type parse_atom()
+        {
+            char c = pattern[position++];
+
+            switch (c)
+            {
+                case '(':
+                {
+                    bool capture = pattern.substr(position, 2) != "?:";
+                    auto group = std::uint32_t(capture ? ++regex.group_count : 0);
+
+                    if (!capture)
+                    {
+                        position += 2;
+                    }
+
+                    index_type inner = parse_alternation();
+
+                    if (!ok || at_end() || peek() != ')')
+                    {
+                        return fail();
+                    }
+
+                    ++position;
+
+                    if (!capture)
+                    {
+                        return inner;
+                    }
+
+                    node_type node;
+                    node.kind = node_type::Kind::Group;
+                    node.left = inner;
+                    node.group = group;
+                    return regex.add(node);
+                }
+                case '[':
+                    return parse_class();
+                case '.':
+                {
+                    if (utf8)
+                    {
+                        return regex.add(CodepointRanges{{0, '\n' - 1}, {'\n' + 1, max_codepoint}});
+                    }
+
+                    ByteSet any;
+                    any.set();
+                    any.reset('\n');
+                    return regex.add(any);
+                }
+                case '*': case '+': case '?': case ')': case ']':
+                    return fail();
+                case '\\':
+                {
+                    int symbol = parse_escape();
+                    return symbol < 0 ? fail() : add_symbol(symbol);
+                }
+                default:
+                {
+                    if (!utf8 || static_cast<unsigned char>(c) < 0x80)
+                    {
+                        return regex.add(ByteSet{}.set(static_cast<unsigned char>(c)));
+                    }
+
+                    --position;
+                    int symbol = utf8_decode(pattern, position);
+                    return symbol < 0 ? fail() : add_symbol(symbol);
+                }
+            }
+        }
+
+        /** Leaf of a byte, or the encoding of a codepoint in UTF-8 mode. */
+        index_type add_symbol(int symbol)
+        {
+            if (utf8)
+            {
+                return regex.add(CodepointRanges{{codepoint_type(symbol), codepoint_type(symbol)}});
+            }
+
+            return regex.add(ByteSet{}.set(symbol));
+        }
+
+        /** Parses the escape after a backslash, returns -1 if it is malformed. */
+        int parse_escape() noexcept
+        {
+            if (at_end())
+            {
+                return -1;
+            }
+
+            char c = pattern[position++];
+
+            switch (c)
+            {
+                case 'n': return '\n';
+                case 't': return '\t';
+                case 'r': return '\r';
+                case 'f': return '\f';
+                case 'v': return '\v';
+                case '0': return '\0';
+                case 'x':
+                {
+                    int value = 0;
+
+                    for (int i = 0; i < 2; ++i)
+                    {
+                        int digit = at_end() ? -1 : hex_value(pattern[position++]);
+
+                        if (digit < 0)
+                        {
+                            return -1;
+                        }
+
+                        value = value * 16 + digit;
+                    }
+
+                    return value;
+                }
+                case 'u':
+                    return utf8 ? parse_codepoint() : 'u';
+                default: return static_cast<unsigned char>(c);
+            }
+        }
+
+        /** Parses the HHHH or {H...} of a \\u escape, returns -1 if it is
+         * malformed or not a codepoint.
+         */
+        int parse_codepoint() noexcept
+        {
+            bool braces = !at_end() && peek() == '{';
+            size_t digits = 0;
+            long value = 0;
+
+            if (braces)
+            {
+                ++position;
+            }
+
+            while (!at_end() && (braces ? peek() != '}' && digits < 6 : digits < 4))
+            {
+                int digit = hex_value(pattern[position++]);
+
+                if (digit < 0)
+                {
+                    return -1;
+                }
+
+                value = value * 16 + digit;
+                ++digits;
+            }
+
+            if (braces)
+            {
+                if (at_end() || peek() != '}')
+                {
+                    return -1;
+                }
+
+                ++position;
+            }
+
+            if (digits == 0 || (!braces && digits != 4) || value > long(max_codepoint) ||
+                (value >= 0xd800 && value <= 0xdfff))
+            {
+                return -1;
+            }
+
+            return int(value);
+        }
+
+        static int hex_value(char c) noexcept
+        {
+            if (c >= '0' && c <= '9')
+            {
+                return c - '0';
+            }
+
+            if (c >= 'a' && c <= 'f')
+            {
+                return c - 'a' + 10;
+            }
+
+            if (c >= 'A' && c <= 'F')
+            {
+                return c - 'A' + 10;
+            }
+
+            return -1;
+        }
+
+        /** Parses a class symbol, returns -1 if it is malformed. */
+        int parse_class_symbol() noexcept
+        {
+            if (at_end())
+            {
+                return -1;
+            }
+
+            if (utf8 && static_cast<unsigned char>(peek()) >= 0x80)
+            {
+                return utf8_decode(pattern, position);
+            }
+
+            char c = pattern[position++];
+
+            return c == '\\' ? parse_escape() : static_cast<unsigned char>(c);
+        }
+
+        index_type parse_class()
+        {
+            ByteSet symbols;
+            CodepointRanges ranges;
+            bool negated = !at_end() && peek() == '^';
+
+            if (negated)
+            {
+                ++position;
+            }
+
+            // A leading ']' is a literal, as in flex.
+            bool first = true;
+
+            while (!at_end() && (peek() != ']' || first))
+            {
+                first = false;
+                int low = parse_class_symbol();
+                int high = low;
+
+                if (position + 1 < pattern.size() && peek() == '-' && pattern[position + 1] != ']')
+                {
+                    ++position;
+                    high = parse_class_symbol();
+                }
+
+                if (low < 0 || high < low)
+                {
+                    return fail();
+                }
+
+                if (utf8)
+                {
+                    ranges.emplace_back(low, high);
+                    continue;
+                }
+
+                for (int symbol = low; symbol <= high; ++symbol)
+                {
+                    symbols.set(symbol);
+                }
+            }
+
+            if (at_end())
+            {
+                return fail();
+            }
+
+            ++position;
+
+            if (utf8)
+            {
+                return regex.add(negated ? codepoint_complement(std::move(ranges)) : ranges);
+            }
+
+            return regex.add(negated ? ~symbols : symbols);
+        }
+    };
+
+    std::vector<node_type> nodes;
+    index_type root_node = node_type::none;
+    size_t group_count = 0;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <DFA.hpp>
+#include <NFA.hpp>
+#include <Regex.hpp>
+
+/** Compiles regular expressions into minimal DFAs.
+ *
+ * Patterns go through Thompson's construction, the subset construction
+ * and Hopcroft's minimization. The automata are cached by pattern text,
+ * so compiling a pattern again returns the automaton built the first time.
+ */
+class RegexCompiler
+{
+public:
+    using dfa_type = DFA<char>;
+
+    /** Returns the automaton of the pattern, or nullptr if it is malformed.
+     *
+     * The pointer stays valid as long as the compiler.
+     */
+    const dfa_type* compile(std::string_view pattern, Regex::Encoding encoding = Regex::Encoding::Bytes)
+    {
+        // The same text is a different pattern in each encoding.
+        std::string key{encoding == Regex::Encoding::Utf8 ? "u:" : "b:"};
+        key += pattern;
+        auto it = cache.find(key);
+
+        if (it != cache.end())
+        {
+            return &it->second;
+        }
+
+        auto regex = Regex::parse(pattern, encoding);
+
+        if (!regex)
+        {
+            return nullptr;
+        }
+
+        NFA nfa{*regex};
+        auto dfa = dfa_type::from_compiled(minimize(nfa.to_dfa()));
+
+        return &cache.emplace(std::move(key), std::move(dfa)).first->second;
+    }
+
+    size_t size() const noexcept
+    {
+        return cache.size();
+    }
+
+    void clear() noexcept
+    {
+        cache.clear();
+    }
+
+private:
+    std::unordered_map<std::string, dfa_type> cache;
+};
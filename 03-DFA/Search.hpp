@@ -0,0 +1,283 @@
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <CompiledDFA.hpp>
+
+/** Unanchored leftmost-longest search with a compiled automaton.
+ *
+ * A forward pass finds where the next match ends and a backward pass from
+ * there finds where it starts, so no offset of the text is scanned more
+ * than twice.
+ *
+ * The forward automaton runs .*R: each of its states is the list of the
+ * states of R reached from the starts seen so far, earliest start first,
+ * a state reached from two starts being kept for the earlier one. Once a
+ * run accepts, the runs from later starts can not be the leftmost match
+ * any more and are dropped, and no new start is taken. The last accepting
+ * position before the automaton dies is then the end of the leftmost-
+ * longest match. The backward automaton is the reverse of R; run from the
+ * end, its last accepting position is the start of the match.
+ *
+ * Empty matches are not reported.
+ */
+template <typename SymbolT, typename SymbolHash>
+class Searcher
+{
+public:
+    using dfa_type    = CompiledDFA<SymbolT, SymbolHash>;
+    using state_type  = typename dfa_type::state_type;
+    using column_type = typename dfa_type::column_type;
+    using word_type   = typename dfa_type::word_type;
+
+    struct Match
+    {
+        size_t offset;
+        size_t length;
+    };
+
+    Searcher(const dfa_type& _dfa)
+        : dfa{_dfa}, columns{_dfa.num_columns()}
+    {
+        build_forward();
+        build_backward();
+    }
+
+    /** Leftmost-longest match that starts at offset or after it. */
+    std::optional<Match> search(word_type text, size_t offset = 0) const noexcept
+    {
+        if (forward.empty())
+        {
+            return std::nullopt;
+        }
+
+        // Forward pass: end of the match.
+        state_type state = 0;
+        size_t end = 0;
+        bool found = false;
+
+        for (size_t i = offset; i < text.size() && state != dead_state; ++i)
+        {
+            state = forward[size_t(state) * (columns + 1) + forward_column(text[i])];
+
+            if (state != dead_state && forward_accepting[state])
+            {
+                end = i + 1;
+                found = true;
+            }
+        }
+
+        if (!found)
+        {
+            return std::nullopt;
+        }
+
+        // Backward pass: start of the match.
+        state = 0;
+        size_t start = end;
+
+        for (size_t i = end; i > offset && state != dead_state; --i)
+        {
+            auto column = dfa.symbol_columns().column(text[i - 1]);
+            state = column == dfa_type::columns_type::no_column ? dead_state : backward[size_t(state) * columns + column];
+
+            if (state != dead_state && backward_accepting[state])
+            {
+                start = i - 1;
+            }
+        }
+
+        return Match{start, end - start};
+    }
+
+    /** Every leftmost-longest match, left to right, without overlaps. */
+    std::vector<Match> find_all(word_type text) const
+    {
+        std::vector<Match> matches;
+
+        for (auto match = search(text); match; match = search(text, match->offset + match->length))
+        {
+            matches.push_back(*match);
+        }
+
+        return matches;
+    }
+
+    size_t forward_states() const noexcept
+    {
+        return forward_accepting.size();
+    }
+
+    size_t backward_states() const noexcept
+    {
+        return backward_accepting.size();
+    }
+
+private:
+    static constexpr state_type dead_state = dfa_type::dead_state;
+
+    /** Symbols that R has no column for kill every run, they get the
+     * extra column of the forward table.
+     */
+    column_type forward_column(const SymbolT& symbol) const noexcept
+    {
+        auto column = dfa.symbol_columns().column(symbol);
+        return column == dfa_type::columns_type::no_column ? column_type(columns) : column;
+    }
+
+    void build_forward()
+    {
+        // Runs of R, whether a run accepted (no new starts are taken) and
+        // whether one just accepted.
+        using key_type = std::tuple<std::vector<state_type>, bool, bool>;
+
+        std::map<key_type, state_type> ids;
+        std::vector<key_type> keys;
+
+        auto add = [&](key_type key)
+        {
+            auto [it, inserted] = ids.emplace(key, state_type(keys.size()));
+
+            if (inserted)
+            {
+                keys.push_back(std::move(key));
+            }
+
+            return it->second;
+        };
+
+        if (dfa.initial_state() == dead_state)
+        {
+            return;
+        }
+
+        add({{dfa.initial_state()}, false, false});
+
+        for (size_t q = 0; q < keys.size(); ++q)
+        {
+            // Adding states moves the keys.
+            auto runs = std::get<0>(keys[q]);
+            bool matched = std::get<1>(keys[q]);
+
+            for (column_type c = 0; c <= columns; ++c)
+            {
+                std::vector<state_type> next;
+
+                for (auto s: runs)
+                {
+                    state_type t = c == columns ? dead_state : dfa.column_delta(s, c);
+
+                    if (t != dead_state && std::find(next.begin(), next.end(), t) == next.end())
+                    {
+                        next.push_back(t);
+                    }
+                }
+
+                auto first = std::find_if(next.begin(), next.end(), [&](state_type s) { return dfa.is_accepting(s); });
+                bool accepts = first != next.end();
+
+                if (accepts)
+                {
+                    next.erase(first + 1, next.end());
+                }
+
+                bool stop = matched || accepts;
+
+                if (!stop && std::find(next.begin(), next.end(), dfa.initial_state()) == next.end())
+                {
+                    next.push_back(dfa.initial_state());
+                }
+
+                forward.push_back(next.empty() ? dead_state : add({std::move(next), stop, accepts}));
+            }
+        }
+
+        for (const auto& key: keys)
+        {
+            forward_accepting.push_back(std::get<2>(key));
+        }
+    }
+
+    void build_backward()
+    {
+        const size_t n = dfa.num_states();
+
+        // Predecessors of every state on every column.
+        std::vector<std::vector<state_type>> predecessors(n * columns);
+
+        for (state_type q = 0; q < n; ++q)
+        {
+            for (column_type c = 0; c < columns; ++c)
+            {
+                state_type t = dfa.column_delta(q, c);
+
+                if (t != dead_state)
+                {
+                    predecessors[size_t(t) * columns + c].push_back(q);
+                }
+            }
+        }
+
+        std::map<std::vector<state_type>, state_type> ids;
+        std::vector<std::vector<state_type>> sets;
+
+        auto add = [&](std::vector<state_type> set)
+        {
+            std::sort(set.begin(), set.end());
+            set.erase(std::unique(set.begin(), set.end()), set.end());
+            auto [it, inserted] = ids.emplace(set, state_type(sets.size()));
+
+            if (inserted)
+            {
+                sets.push_back(std::move(set));
+            }
+
+            return it->second;
+        };
+
+        std::vector<state_type> finals;
+
+        for (state_type q = 0; q < n; ++q)
+        {
+            if (dfa.is_accepting(q))
+            {
+                finals.push_back(q);
+            }
+        }
+
+        add(finals);
+
+        for (size_t i = 0; i < sets.size(); ++i)
+        {
+            for (column_type c = 0; c < columns; ++c)
+            {
+                std::vector<state_type> previous;
+
+                for (auto t: sets[i])
+                {
+                    const auto& p = predecessors[size_t(t) * columns + c];
+                    previous.insert(previous.end(), p.begin(), p.end());
+                }
+
+                backward.push_back(previous.empty() ? dead_state : add(std::move(previous)));
+            }
+        }
+
+        for (const auto& set: sets)
+        {
+            backward_accepting.push_back(std::binary_search(set.begin(), set.end(), dfa.initial_state()));
+        }
+    }
+
+    const dfa_type& dfa;
+    size_t columns;
+
+    std::vector<state_type> forward;
+    std::vector<bool> forward_accepting;
+    std::vector<state_type> backward;
+    std::vector<bool> backward_accepting;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/** Bytes on which a state of a byte DFA goes back to itself, as a few
+ * ranges.
+ *
+ * skip() jumps over whole blocks of bytes that keep the automaton in the
+ * state: 32 bytes per step with AVX2 or 16 with SSE2, whichever the
+ * compiler targets. The bytes after the last block are left to the
+ * caller, and so is the whole input when neither is available, so the
+ * transition table is the scalar fallback.
+ */
+struct SelfLoop
+{
+#if defined(__AVX2__)
+    using vector_type = __m256i;
+#elif defined(__SSE2__)
+    using vector_type = __m128i;
+#else
+    using vector_type = std::uint8_t;
+#endif
+
+    static constexpr unsigned max_ranges = 4;
+    static constexpr long block_size = sizeof(vector_type);
+
+    unsigned count = 0;
+    vector_type lows[max_ranges];
+    vector_type spans[max_ranges];
+
+    /** Adds the range [low, high] of bytes. There is room for max_ranges. */
+    void add_range(std::uint8_t low, std::uint8_t high) noexcept
+    {
+#if defined(__AVX2__)
+        lows[count] = _mm256_set1_epi8(char(low));
+        spans[count] = _mm256_set1_epi8(char(high - low));
+#elif defined(__SSE2__)
+        lows[count] = _mm_set1_epi8(char(low));
+        spans[count] = _mm_set1_epi8(char(high - low));
+#else
+        lows[count] = low;
+        spans[count] = std::uint8_t(high - low);
+#endif
+        ++count;
+    }
+
+    /** Returns the first position in [p, end) whose byte leaves the state,
+     * or the start of the last incomplete block if there is none before it.
+     */
+    const char* skip(const char* p, const char* end) const noexcept
+    {
+#if defined(__AVX2__)
+        for (; end - p >= block_size; p += block_size)
+        {
+            __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i inside = _mm256_setzero_si256();
+
+            for (unsigned i = 0; i < count; ++i)
+            {
+                __m256i offset = _mm256_sub_epi8(bytes, lows[i]);
+                inside = _mm256_or_si256(inside, _mm256_cmpeq_epi8(_mm256_min_epu8(offset, spans[i]), offset));
+            }
+
+            std::uint32_t mask = std::uint32_t(_mm256_movemask_epi8(inside));
+
+            if (mask != UINT32_MAX)
+            {
+                return p + __builtin_ctz(~mask);
+            }
+        }
+#elif defined(__SSE2__)
+        for (; end - p >= block_size; p += block_size)
+        {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i inside = _mm_setzero_si128();
+
+            for (unsigned i = 0; i < count; ++i)
+            {
+                __m128i offset = _mm_sub_epi8(bytes, lows[i]);
+                inside = _mm_or_si128(inside, _mm_cmpeq_epi8(_mm_min_epu8(offset, spans[i]), offset));
+            }
+
+            unsigned mask = unsigned(_mm_movemask_epi8(inside));
+
+            if (mask != 0xffff)
+            {
+                return p + __builtin_ctz(~mask);
+            }
+        }
+#else
+        (void) end;
+#endif
+        return p;
+    }
+};
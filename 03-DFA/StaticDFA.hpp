@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/** DFA over bytes whose tables can be built and used in constant expressions.
+ *
+ * The number of states is a template parameter, so the transition table is
+ * a std::array and a constexpr automaton lives in read-only data with no
+ * static initializer. The table has one column per byte and missing
+ * transitions go to dead_state.
+ */
+template <size_t States>
+class StaticDFA
+{
+public:
+    using state_type = std::conditional_t<(States < UINT8_MAX), std::uint8_t, std::uint16_t>;
+    using word_type  = std::string_view;
+
+    static_assert(States < UINT16_MAX, "Too many states for a static DFA");
+
+    static constexpr state_type dead_state = States;
+
+    constexpr StaticDFA() noexcept
+        : table{}, accepting{}
+    {
+        for (auto& next: table)
+        {
+            next = dead_state;
+        }
+    }
+
+    constexpr void set_initial_state(size_t state) noexcept
+    {
+        initial_state = state_type(state);
+    }
+
+    constexpr void add_acceptation_state(size_t state) noexcept
+    {
+        accepting[state] = true;
+    }
+
+    constexpr void add_transition(size_t state0, size_t state1, char symbol) noexcept
+    {
+        table[state0 * 256 + static_cast<unsigned char>(symbol)] = state_type(state1);
+    }
+
+    /** Adds the transitions for every symbol between first and last. */
+    constexpr void add_range(size_t state0, size_t state1, char first, char last) noexcept
+    {
+        for (int symbol = static_cast<unsigned char>(first); symbol <= static_cast<unsigned char>(last); ++symbol)
+        {
+            table[state0 * 256 + symbol] = state_type(state1);
+        }
+    }
+
+    constexpr state_type delta(state_type state, char symbol) const noexcept
+    {
+        return table[state * 256 + static_cast<unsigned char>(symbol)];
+    }
+
+    constexpr bool is_accepting(state_type state) const noexcept
+    {
+        return state != dead_state && accepting[state];
+    }
+
+    constexpr bool match(word_type word) const noexcept
+    {
+        state_type state = initial_state;
+
+        for (char symbol: word)
+        {
+            if (state == dead_state)
+            {
+                return false;
+            }
+
+            state = delta(state, symbol);
+        }
+
+        return is_accepting(state);
+    }
+
+private:
+    std::array<state_type, States * 256> table;
+    std::array<bool, States> accepting;
+    state_type initial_state = 0;
+};
@@ -0,0 +1,539 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <NFA.hpp>
+#include <Regex.hpp>
+
+/** Tagged DFA, after Laurikari, that matches a whole text and reports
+ * where its capture groups matched.
+ *
+ * The entry and exit of each group are tags of the NFA. A state of the
+ * automaton is an ordered list of NFA states, each with one register per
+ * tag that holds the last position where the tag was crossed on the way
+ * to it. Transitions carry register operations that either copy a
+ * register or store the current position, so a single pass over the text
+ * records the groups without backtracking.
+ *
+ * The NFA states of a state are ordered by priority, as in a backtracking
+ * matcher: the left branch of an alternation before the right one and
+ * closures greedy. Two paths reaching the same NFA state keep the one of
+ * higher priority, so the groups are those of the leftmost greedy match.
+ * A group inside a closure reports its last iteration, and a group that
+ * took no part in the match reports npos.
+ *
+ * States with the same NFA states whose registers only differ by their
+ * names are merged, the transition renaming the registers.
+ */
+class TaggedDFA
+{
+public:
+    using state_type    = std::uint32_t;
+    using register_type = std::uint32_t;
+    using word_type     = std::string_view;
+
+    static constexpr state_type dead_state = UINT32_MAX;
+    static constexpr size_t npos = SIZE_MAX;
+
+    /** Tags of a group fit in the 64 bits of a tag set. */
+    static constexpr size_t max_groups = 32;
+
+    /** Offsets of the groups of the last match, along with the registers
+     * used to find them. Reusing the same Captures across matches saves
+     * allocating either.
+     */
+    struct Captures
+    {
+        std::vector<size_t> offsets;
+        std::vector<size_t> registers;
+
+        /** Group 0 is the whole text. */
+        size_t start(size_t group) const noexcept
+        {
+            return offsets[2 * group];
+        }
+
+        size_t end(size_t group) const noexcept
+        {
+            return offsets[2 * group + 1];
+        }
+
+        bool matched(size_t group) const noexcept
+        {
+            return offsets[2 * group] != npos && offsets[2 * group + 1] != npos;
+        }
+    };
+
+    /** The result is empty when the pattern is malformed or has more than
+     * max_groups groups.
+     */
+    static std::optional<TaggedDFA> compile(std::string_view pattern,
+                                            Regex::Encoding encoding = Regex::Encoding::Bytes)
+    {
+        auto regex = Regex::parse(pattern, encoding);
+
+        if (!regex)
+        {
+            return std::nullopt;
+        }
+
+        return build(*regex);
+    }
+
+    static std::optional<TaggedDFA> build(const Regex& regex)
+    {
+        if (regex.groups() > max_groups)
+        {
+            return std::nullopt;
+        }
+
+        TaggedDFA result;
+        Builder{result, NFA{regex}, regex.groups()}.run();
+        return result;
+    }
+
+    size_t num_groups() const noexcept
+    {
+        return groups;
+    }
+
+    size_t num_states() const noexcept
+    {
+        return accepting.size();
+    }
+
+    size_t num_registers() const noexcept
+    {
+        return registers;
+    }
+
+    /** Whether the whole text matches; if it does, the captures hold where
+     * each group matched.
+     */
+    bool match(word_type text, Captures& captures) const noexcept
+    {
+        captures.registers.assign(registers, npos);
+        run(initial_operations, 0, captures.registers);
+
+        state_type state = initial;
+
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            const Transition& transition = table[size_t(state) * columns + class_map[static_cast<unsigned char>(text[i])]];
+
+            if (transition.next == dead_state)
+            {
+                return false;
+            }
+
+            run(transition.operations, i + 1, captures.registers);
+            state = transition.next;
+        }
+
+        if (!accepting[state])
+        {
+            return false;
+        }
+
+        captures.offsets.resize(2 * (groups + 1));
+        captures.offsets[0] = 0;
+        captures.offsets[1] = text.size();
+
+        for (size_t t = 0; t < 2 * groups; ++t)
+        {
+            captures.offsets[t + 2] = captures.registers[finals[state * 2 * groups + t]];
+        }
+
+        return true;
+    }
+
+    bool match(word_type text) const noexcept
+    {
+        Captures captures;
+        return match(text, captures);
+    }
+
+private:
+    /** Source of the operations that store the current position. */
+    static constexpr register_type position = UINT32_MAX;
+
+    /** target = position if source is position, else target = source. */
+    struct Operation
+    {
+        register_type target;
+        register_type source;
+    };
+
+    /** Range of the operations array. */
+    struct Operations
+    {
+        std::uint32_t first = 0;
+        std::uint32_t count = 0;
+    };
+
+    struct Transition
+    {
+        state_type next = dead_state;
+        Operations operations;
+    };
+
+    /** Subset construction with registers. */
+    struct Builder
+    {
+        using tag_set_type = std::uint64_t;
+
+        /** Values of the registers of a new state: registers of the state
+         * the transition leaves, or fresh_value for the current position.
+         */
+        static constexpr register_type fresh_value = UINT32_MAX - 1;
+
+        /** Stands for the scratch register until the registers are counted. */
+        static constexpr register_type scratch_marker = UINT32_MAX - 2;
+
+        TaggedDFA& dfa;
+        NFA nfa;
+        size_t tag_count;
+        std::vector<std::uint32_t> marks;
+        std::uint32_t generation = 0;
+
+        // NFA states of each state, and register of each tag of each.
+        std::vector<NFA::state_set_type> kernels;
+        std::vector<std::vector<register_type>> assignments;
+        std::map<NFA::state_set_type, std::vector<state_type>> by_kernel;
+
+        register_type register_count = 1;
+        std::vector<std::uint8_t> symbols;
+
+        Builder(TaggedDFA& _dfa, NFA _nfa, size_t _groups)
+            : dfa{_dfa}, nfa{std::move(_nfa)}, tag_count{2 * _groups}, marks(nfa.size(), 0)
+        {
+            dfa.groups = _groups;
+        }
+
+        void run()
+        {
+            build_columns();
+
+            // Before the first byte every tag is unset, which is the value
+            // of register 0 and of any register never written.
+            NFA::state_set_type kernel;
+            std::vector<register_type> values;
+            std::vector<register_type> unset(tag_count, 0);
+            ++generation;
+            closure(nfa.initial_state(), unset.data(), kernel, values);
+
+            std::vector<std::pair<register_type, register_type>> moves;
+            dfa.initial = add(std::move(kernel), std::move(values), moves);
+            dfa.initial_operations = emit(moves);
+
+            for (state_type q = 0; q < kernels.size(); ++q)
+            {
+                for (size_t column = 0; column < dfa.columns; ++column)
+                {
+                    step(q, column);
+                }
+            }
+
+            // One more register to break cycles of copies.
+            dfa.registers = register_count + 1;
+
+            for (auto& operation: dfa.operations)
+            {
+                for (auto* r: {&operation.target, &operation.source})
+                {
+                    *r = *r == scratch_marker ? register_count : *r;
+                }
+            }
+
+            // The registers of a match are those of the NFA state of highest
+            // priority that accepts.
+            dfa.accepting.assign(kernels.size(), false);
+            dfa.finals.assign(kernels.size() * tag_count, 0);
+
+            for (state_type q = 0; q < kernels.size(); ++q)
+            {
+                auto& kernel = kernels[q];
+                auto i = size_t(std::find(kernel.begin(), kernel.end(), nfa.acceptation_state()) - kernel.begin());
+
+                if (i < kernel.size())
+                {
+                    dfa.accepting[q] = true;
+                    std::copy_n(&assignments[q][i * tag_count], tag_count, &dfa.finals[q * tag_count]);
+                }
+            }
+        }
+
+        /** Bytes that no NFA transition tells apart share a column. */
+        void build_columns()
+        {
+            unsigned count = 1;
+
+            for (NFA::state_type s = 0; s < nfa.size(); ++s)
+            {
+                const auto& state = nfa.state(s);
+
+                if (state.next == NFA::none)
+                {
+                    continue;
+                }
+
+                std::vector<std::uint8_t> split(size_t(count) * 2, 0);
+                std::vector<std::uint8_t> renumber(size_t(count) * 2, 0);
+                unsigned next_count = 0;
+
+                for (size_t symbol = 0; symbol < 256; ++symbol)
+                {
+                    size_t k = size_t(dfa.class_map[symbol]) * 2 + state.symbols.test(symbol);
+
+                    if (!split[k])
+                    {
+                        split[k] = 1;
+                        renumber[k] = std::uint8_t(next_count++);
+                    }
+
+                    dfa.class_map[symbol] = renumber[k];
+                }
+
+                count = next_count;
+            }
+
+            dfa.columns = count;
+            symbols.assign(count, 0);
+
+            for (size_t symbol = 256; symbol-- > 0;)
+            {
+                symbols[dfa.class_map[symbol]] = std::uint8_t(symbol);
+            }
+        }
+
+        /** Appends the NFA states reached from s through epsilon transitions
+         * in priority order, skipping those already reached in this step,
+         * with the values of their tags. Tags crossed on the way take the
+         * current position.
+         */
+        void closure(NFA::state_type s, const register_type* registers,
+                     NFA::state_set_type& kernel, std::vector<register_type>& values)
+        {
+            std::vector<std::pair<NFA::state_type, tag_set_type>> stack{{s, 0}};
+
+            while (!stack.empty())
+            {
+                auto [state, crossed] = stack.back();
+                stack.pop_back();
+
+                if (state == NFA::none || marks[state] == generation)
+                {
+                    continue;
+                }
+
+                marks[state] = generation;
+                const auto& node = nfa.state(state);
+
+                if (node.tag != NFA::none)
+                {
+                    crossed |= tag_set_type{1} << (node.tag - 2);
+                }
+
+                if (node.next != NFA::none || state == nfa.acceptation_state())
+                {
+                    kernel.push_back(state);
+
+                    for (size_t t = 0; t < tag_count; ++t)
+                    {
+                        values.push_back(crossed >> t & 1 ? fresh_value : registers[t]);
+                    }
+                }
+
+                stack.emplace_back(node.epsilon[1], crossed);
+                stack.emplace_back(node.epsilon[0], crossed);
+            }
+        }
+
+        void step(state_type q, size_t column)
+        {
+            NFA::state_set_type kernel;
+            std::vector<register_type> values;
+            ++generation;
+
+            for (size_t i = 0; i < kernels[q].size(); ++i)
+            {
+                const auto& node = nfa.state(kernels[q][i]);
+
+                if (node.next != NFA::none && node.symbols.test(symbols[column]))
+                {
+                    closure(node.next, &assignments[q][i * tag_count], kernel, values);
+                }
+            }
+
+            Transition transition;
+
+            if (!kernel.empty())
+            {
+                std::vector<std::pair<register_type, register_type>> moves;
+                transition.next = add(std::move(kernel), std::move(values), moves);
+                transition.operations = emit(moves);
+            }
+
+            dfa.table.resize(std::max(dfa.table.size(), (size_t(q) + 1) * dfa.columns));
+            dfa.table[size_t(q) * dfa.columns + column] = transition;
+        }
+
+        /** State with the kernel and register values, made up if no state
+         * has both up to renaming. The moves set its registers from the
+         * values.
+         */
+        state_type add(NFA::state_set_type kernel, std::vector<register_type> values,
+                       std::vector<std::pair<register_type, register_type>>& moves)
+        {
+            auto& candidates = by_kernel[kernel];
+
+            for (state_type candidate: candidates)
+            {
+                if (rename(values, assignments[candidate], moves))
+                {
+                    return candidate;
+                }
+            }
+
+            // Values that are registers stay in them; the position goes to
+            // the first register no value uses.
+            std::vector<bool> used(register_count + 1, false);
+
+            for (register_type value: values)
+            {
+                if (value != fresh_value)
+                {
+                    used[value] = true;
+                }
+            }
+
+            register_type fresh = register_type(std::find(used.begin(), used.end(), false) - used.begin());
+            register_count = std::max(register_count, fresh + 1);
+            bool stored = false;
+
+            for (register_type& value: values)
+            {
+                if (value == fresh_value)
+                {
+                    value = fresh;
+                    stored = true;
+                }
+            }
+
+            moves.clear();
+
+            if (stored)
+            {
+                moves.emplace_back(fresh, position);
+            }
+
+            auto id = state_type(kernels.size());
+            candidates.push_back(id);
+            kernels.push_back(std::move(kernel));
+            assignments.push_back(std::move(values));
+            return id;
+        }
+
+        /** Whether the values map one to one onto the registers; if they
+         * do, the moves copy each value to its register.
+         */
+        static bool rename(const std::vector<register_type>& values, const std::vector<register_type>& target,
+                           std::vector<std::pair<register_type, register_type>>& moves)
+        {
+            std::map<register_type, register_type> forward;
+            std::map<register_type, register_type> backward;
+
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                auto [f, new_forward] = forward.emplace(values[i], target[i]);
+                auto [b, new_backward] = backward.emplace(target[i], values[i]);
+
+                if (f->second != target[i] || b->second != values[i])
+                {
+                    return false;
+                }
+            }
+
+            moves.clear();
+
+            for (auto [value, r]: forward)
+            {
+                if (value != r)
+                {
+                    moves.emplace_back(r, value == fresh_value ? position : value);
+                }
+            }
+
+            return true;
+        }
+
+        /** Orders moves that happen at once so that no register is written
+         * before it is read, going through the scratch register to break
+         * cycles, and appends them to the operations.
+         */
+        Operations emit(std::vector<std::pair<register_type, register_type>> moves)
+        {
+            Operations result{std::uint32_t(dfa.operations.size()), 0};
+
+            while (!moves.empty())
+            {
+                auto ready = std::find_if(moves.begin(), moves.end(), [&](const auto& move)
+                {
+                    return std::none_of(moves.begin(), moves.end(),
+                                        [&](const auto& other) { return other.second == move.first; });
+                });
+
+                if (ready == moves.end())
+                {
+                    // Every target is still to be read: save one of them.
+                    register_type saved = moves.front().first;
+                    dfa.operations.push_back({scratch_marker, saved});
+
+                    for (auto& move: moves)
+                    {
+                        move.second = move.second == saved ? scratch_marker : move.second;
+                    }
+
+                    continue;
+                }
+
+                dfa.operations.push_back({ready->first, ready->second});
+                moves.erase(ready);
+            }
+
+            result.count = std::uint32_t(dfa.operations.size() - result.first);
+            return result;
+        }
+    };
+
+    TaggedDFA() = default;
+
+    void run(Operations range, size_t offset, std::vector<size_t>& values) const noexcept
+    {
+        for (std::uint32_t i = range.first; i < range.first + range.count; ++i)
+        {
+            const Operation& operation = operations[i];
+            values[operation.target] = operation.source == position ? offset : values[operation.source];
+        }
+    }
+
+    size_t groups = 0;
+    std::array<std::uint8_t, 256> class_map{};
+    size_t columns = 1;
+    state_type initial = dead_state;
+    Operations initial_operations;
+    std::vector<Transition> table;
+    std::vector<Operation> operations;
+
+    // For each accepting state, the register of each tag.
+    std::vector<bool> accepting;
+    std::vector<register_type> finals;
+    register_type registers = 0;
+};
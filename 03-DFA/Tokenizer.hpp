@@ -0,0 +1,217 @@
+#pragma once
+
+#include <map>
+#include <string_view>
+#include <vector>
+
+#include <AlphabetCompression.hpp>
+#include <CompiledDFA.hpp>
+#include <DFA.hpp>
+#include <Minimization.hpp>
+
+/** Product construction that merges several compiled automata into one.
+ *
+ * A state of the result is a tuple with one state of each automaton, and
+ * only the tuples reachable from the initial one are built. It accepts
+ * when any component accepts, and it is tagged with the index of the
+ * first such automaton: as in flex, the earlier rule wins a tie.
+ */
+template <typename SymbolT, typename SymbolHash>
+CompiledDFA<SymbolT, SymbolHash> unite(const std::vector<CompiledDFA<SymbolT, SymbolHash>>& automata)
+{
+    using dfa_type     = CompiledDFA<SymbolT, SymbolHash>;
+    using state_type   = typename dfa_type::state_type;
+    using column_type  = typename dfa_type::column_type;
+    using columns_type = typename dfa_type::columns_type;
+    using tuple_type   = std::vector<state_type>;
+
+    std::vector<SymbolT> symbols;
+
+    for (const auto& automaton: automata)
+    {
+        const auto& columns = automaton.symbol_columns();
+
+        for (column_type c = 0; c < columns.size(); ++c)
+        {
+            columns.for_each_symbol(c, [&](const SymbolT& symbol) { symbols.push_back(symbol); });
+        }
+    }
+
+    columns_type shared{symbols};
+
+    // Column of each automaton for every shared column.
+    std::vector<std::vector<column_type>> column_of(automata.size());
+
+    for (size_t i = 0; i < automata.size(); ++i)
+    {
+        for (column_type c = 0; c < shared.size(); ++c)
+        {
+            column_of[i].push_back(automata[i].symbol_columns().column(shared.symbol(c)));
+        }
+    }
+
+    std::map<tuple_type, state_type> ids;
+    std::vector<tuple_type> tuples;
+    std::vector<state_type> rows;
+
+    auto add = [&](tuple_type tuple)
+    {
+        auto [it, inserted] = ids.emplace(tuple, state_type(tuples.size()));
+
+        if (inserted)
+        {
+            tuples.push_back(std::move(tuple));
+        }
+
+        return it->second;
+    };
+
+    tuple_type initial;
+
+    for (const auto& automaton: automata)
+    {
+        initial.push_back(automaton.initial_state());
+    }
+
+    add(initial);
+
+    for (size_t q = 0; q < tuples.size(); ++q)
+    {
+        for (column_type c = 0; c < shared.size(); ++c)
+        {
+            tuple_type next(automata.size(), dfa_type::dead_state);
+            bool alive = false;
+
+            for (size_t i = 0; i < automata.size(); ++i)
+            {
+                state_type s = tuples[q][i];
+
+                if (s != dfa_type::dead_state && column_of[i][c] != columns_type::no_column)
+                {
+                    next[i] = automata[i].column_delta(s, column_of[i][c]);
+                    alive = alive || next[i] != dfa_type::dead_state;
+                }
+            }
+
+            rows.push_back(alive ? add(std::move(next)) : dfa_type::dead_state);
+        }
+    }
+
+    dfa_type result{shared, tuples.size(), 0};
+
+    for (state_type q = 0; q < tuples.size(); ++q)
+    {
+        for (column_type c = 0; c < shared.size(); ++c)
+        {
+            result.set_transition(q, c, rows[size_t(q) * shared.size() + c]);
+        }
+
+        for (size_t i = 0; i < automata.size(); ++i)
+        {
+            if (automata[i].is_accepting(tuples[q][i]))
+            {
+                result.set_accepting(q, typename dfa_type::rule_type(i));
+                break;
+            }
+        }
+    }
+
+    if constexpr (is_byte_symbol_v<SymbolT>)
+    {
+        return compress_alphabet(result);
+    }
+    else
+    {
+        return result;
+    }
+}
+
+/** Single pass scanner over the union of several automata.
+ *
+ * Each token is the longest prefix of the remaining input accepted by any
+ * of the automata; among the automata that accept it, the one added first
+ * gives the rule of the token.
+ */
+template <typename SymbolT, typename SymbolHash = std::hash<SymbolT>>
+class Tokenizer
+{
+public:
+    using dfa_type      = CompiledDFA<SymbolT, SymbolHash>;
+    using rule_type     = typename dfa_type::rule_type;
+    using word_type     = typename dfa_type::word_type;
+
+    static constexpr rule_type no_rule = dfa_type::no_rule;
+
+    /** A token is a slice of the buffer. Input that no rule matches comes
+     * out one symbol at a time with no_rule.
+     */
+    struct Token
+    {
+        rule_type rule;
+        size_t offset;
+        size_t length;
+    };
+
+    Tokenizer(const std::vector<DFA<SymbolT, SymbolHash>>& automata)
+    {
+        std::vector<dfa_type> compiled;
+
+        for (const auto& automaton: automata)
+        {
+            compiled.push_back(automaton.compile());
+        }
+
+        dfa = minimize(unite(compiled));
+    }
+
+    Tokenizer(dfa_type _dfa) noexcept
+        : dfa{std::move(_dfa)}
+    {
+
+    }
+
+    const dfa_type& automaton() const noexcept
+    {
+        return dfa;
+    }
+
+    /** Longest match starting at offset, which must be inside the buffer. */
+    Token next(word_type buffer, size_t offset) const noexcept
+    {
+        Token token{no_rule, offset, 1};
+        auto state = dfa.initial_state();
+
+        for (size_t i = offset; state != dfa_type::dead_state; ++i)
+        {
+            if (dfa.is_accepting(state) && i > offset)
+            {
+                token.rule = dfa.rule(state);
+                token.length = i - offset;
+            }
+
+            if (i == buffer.size())
+            {
+                break;
+            }
+
+            state = dfa.delta(state, buffer[i]);
+        }
+
+        return token;
+    }
+
+    std::vector<Token> tokenize(word_type buffer) const
+    {
+        std::vector<Token> tokens;
+
+        for (size_t offset = 0; offset < buffer.size(); offset += tokens.back().length)
+        {
+            tokens.push_back(next(buffer, offset));
+        }
+
+        return tokens;
+    }
+
+private:
+    dfa_type dfa;
+};
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/** UTF-8 helpers for compiling codepoint ranges into byte automata.
+ *
+ * A range of codepoints is split, as in Russ Cox's utf8-ranges, into
+ * sequences of byte ranges such that the encodings of the codepoints are
+ * exactly the byte strings matching one of the sequences. Surrogates are
+ * never encoded, so an automaton built from the sequences rejects invalid
+ * UTF-8 on its own: overlong forms, surrogates, stray continuation bytes
+ * and codepoints past U+10FFFF all lead to the dead state.
+ */
+
+using codepoint_type = std::uint32_t;
+
+/** Inclusive range of bytes at one position of an encoding. */
+using ByteRange = std::pair<std::uint8_t, std::uint8_t>;
+
+/** One to four byte ranges, one per byte of the encoding. */
+using Utf8Sequence = std::vector<ByteRange>;
+
+/** Set of codepoints as inclusive ranges, in any order. */
+using CodepointRanges = std::vector<std::pair<codepoint_type, codepoint_type>>;
+
+constexpr codepoint_type max_codepoint = 0x10ffff;
+
+/** Encodes a codepoint into bytes, returns their number. */
+inline size_t utf8_encode(codepoint_type codepoint, std::uint8_t* bytes) noexcept
+{
+    if (codepoint < 0x80)
+    {
+        bytes[0] = std::uint8_t(codepoint);
+        return 1;
+    }
+
+    if (codepoint < 0x800)
+    {
+        bytes[0] = std::uint8_t(0xc0 | codepoint >> 6);
+        bytes[1] = std::uint8_t(0x80 | (codepoint & 0x3f));
+        return 2;
+    }
+
+    if (codepoint < 0x10000)
+    {
+        bytes[0] = std::uint8_t(0xe0 | codepoint >> 12);
+        bytes[1] = std::uint8_t(0x80 | (codepoint >> 6 & 0x3f));
+        bytes[2] = std::uint8_t(0x80 | (codepoint & 0x3f));
+        return 3;
+    }
+
+    bytes[0] = std::uint8_t(0xf0 | codepoint >> 18);
+    bytes[1] = std::uint8_t(0x80 | (codepoint >> 12 & 0x3f));
+    bytes[2] = std::uint8_t(0x80 | (codepoint >> 6 & 0x3f));
+    bytes[3] = std::uint8_t(0x80 | (codepoint & 0x3f));
+    return 4;
+}
+
+/** Decodes the codepoint at position and moves past it. Returns -1 and
+ * leaves position alone if the bytes there are not valid UTF-8.
+ */
+inline std::int32_t utf8_decode(std::string_view text, size_t& position) noexcept
+{
+    auto byte = [&](size_t i) { return static_cast<std::uint8_t>(text[i]); };
+
+    std::uint8_t lead = byte(position);
+    size_t length = lead < 0x80 ? 1 : lead < 0xc2 ? 0 : lead < 0xe0 ? 2 : lead < 0xf0 ? 3 : lead < 0xf5 ? 4 : 0;
+
+    if (length == 0 || position + length > text.size())
+    {
+        return -1;
+    }
+
+    static constexpr std::uint8_t lead_mask[] = {0, 0x7f, 0x1f, 0x0f, 0x07};
+    codepoint_type codepoint = lead & lead_mask[length];
+
+    for (size_t i = 1; i < length; ++i)
+    {
+        if ((byte(position + i) & 0xc0) != 0x80)
+        {
+            return -1;
+        }
+
+        codepoint = codepoint << 6 | (byte(position + i) & 0x3f);
+    }
+
+    static constexpr codepoint_type smallest[] = {0, 0, 0x80, 0x800, 0x10000};
+
+    if (codepoint < smallest[length] || codepoint > max_codepoint || (codepoint >= 0xd800 && codepoint <= 0xdfff))
+    {
+        return -1;
+    }
+
+    position += length;
+    return std::int32_t(codepoint);
+}
+
+/** Byte sequences whose union encodes exactly the codepoints of
+ * [first, last], surrogates excepted.
+ */
+inline void utf8_sequences(codepoint_type first, codepoint_type last, std::vector<Utf8Sequence>& sequences)
+{
+    if (first > last)
+    {
+        return;
+    }
+
+    // Leave the surrogates out.
+    if (first <= 0xdfff && last >= 0xd800)
+    {
+        if (first < 0xd800)
+        {
+            utf8_sequences(first, 0xd7ff, sequences);
+        }
+
+        if (last > 0xdfff)
+        {
+            utf8_sequences(0xe000, last, sequences);
+        }
+
+        return;
+    }
+
+    // Both ends must have encodings of the same length.
+    for (codepoint_type bound: {0x7fu, 0x7ffu, 0xffffu})
+    {
+        if (first <= bound && last > bound)
+        {
+            utf8_sequences(first, bound, sequences);
+            utf8_sequences(bound + 1, last, sequences);
+            return;
+        }
+    }
+
+    // Each continuation byte must cover a whole run of 64 values or share
+    // every byte before it.
+    for (unsigned i = 1; i < 4; ++i)
+    {
+        codepoint_type mask = (codepoint_type{1} << 6 * i) - 1;
+
+        if ((first & ~mask) != (last & ~mask))
+        {
+            if ((first & mask) != 0)
+            {
+                utf8_sequences(first, first | mask, sequences);
+                utf8_sequences((first | mask) + 1, last, sequences);
+                return;
+            }
+
+            if ((last & mask) != mask)
+            {
+                utf8_sequences(first, (last & ~mask) - 1, sequences);
+                utf8_sequences(last & ~mask, last, sequences);
+                return;
+            }
+        }
+    }
+
+    std::uint8_t low[4], high[4];
+    size_t length = utf8_encode(first, low);
+    utf8_encode(last, high);
+
+    Utf8Sequence sequence;
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        sequence.emplace_back(low[i], high[i]);
+    }
+
+    sequences.push_back(std::move(sequence));
+}
+
+/** Codepoints of [0, max_codepoint] that are not in the set. */
+inline CodepointRanges codepoint_complement(CodepointRanges ranges)
+{
+    std::sort(ranges.begin(), ranges.end());
+
+    CodepointRanges result;
+    codepoint_type next = 0;
+
+    for (auto [first, last]: ranges)
+    {
+        if (first > next)
+        {
+            result.emplace_back(next, first - 1);
+        }
+
+        next = std::max(next, last + 1);
+    }
+
+    if (next <= max_codepoint)
+    {
+        result.emplace_back(next, max_codepoint);
+    }
+
+    return result;
+}
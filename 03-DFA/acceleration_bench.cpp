@@ -0,0 +1,45 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Benchmark.hpp>
+
+void report(const std::string& name, const fa_type& fa, const std::vector<std::string>& words)
+{
+    auto accelerated = fa.minimize().compile();
+    auto plain = accelerated;
+    plain.accelerate(false);
+    size_t matches_before, matches_after;
+    double before = throughput([&](std::string_view word) { return plain.match(word); },
+                               words, matches_before);
+    double after = throughput([&](std::string_view word) { return accelerated.match(word); },
+                              words, matches_after);
+
+    std::cout << name << " (words of " << words.front().size() << " bytes):\n"
+              << "  throughput: " << before << " -> " << after << " MB/s\n"
+              << "  matches:    " << matches_before << " -> " << matches_after << "\n";
+}
+
+int main()
+{
+    auto identifier = make_identifier_automaton();
+    auto integer = make_integer_automaton();
+
+    for (size_t length: {8, 64, 1024})
+    {
+        auto words = make_words(1 << 20 >> (length / 8 > 8 ? 7 : 3), length);
+
+        // Most words must stay in the loop states to show the skipping.
+        for (auto& word: words)
+        {
+            word[0] = 'a';
+        }
+
+        report("identifier", identifier, words);
+    }
+
+    std::vector<std::string> numbers(1 << 12, std::string(1024, '7'));
+    report("integer", integer, numbers);
+
+    return EXIT_SUCCESS;
+}
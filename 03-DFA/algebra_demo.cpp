@@ -0,0 +1,37 @@
+#include <iostream>
+#include <string>
+
+#include <Benchmark.hpp>
+
+void show(const std::string& name, const std::optional<std::vector<char>>& word)
+{
+    std::cout << name << ": ";
+
+    if (word)
+    {
+        std::cout << "differ on \"" << std::string(word->begin(), word->end()) << "\"\n";
+    }
+    else
+    {
+        std::cout << "equivalent\n";
+    }
+}
+
+int main()
+{
+    auto keyword = make_for_automaton();
+    auto identifier = make_identifier_automaton();
+    auto integer = make_integer_automaton();
+
+    // A refactored automaton must accept the same words as the old one.
+    show("identifier and its minimal automaton", identifier.counterexample(identifier.minimize()));
+    show("identifier and integer", identifier.counterexample(integer));
+
+    // Tokens that overlap: the keyword is also an identifier.
+    auto overlap = keyword.intersect(identifier);
+    std::cout << "for is " << (overlap.match("for") ? "" : "not ") << "both a keyword and an identifier\n";
+    show("identifiers that are not for", identifier.difference(keyword).counterexample(identifier));
+    show("integers and no integers", integer.intersect(integer.complement()).counterexample(DFA<char>{}));
+
+    return EXIT_SUCCESS;
+}
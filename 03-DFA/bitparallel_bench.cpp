@@ -0,0 +1,83 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Benchmark.hpp>
+#include <BitParallelNFA.hpp>
+
+void report(const std::string& name, const fa_type& fa, std::string_view pattern,
+            const std::vector<std::string>& words)
+{
+    auto table = fa.minimize().compile();
+    auto glushkov = *BitParallelNFA::build(*Regex::parse(pattern));
+    size_t matches_table, matches_glushkov;
+    double table_speed = throughput([&](std::string_view word) { return table.match(word); },
+                                    words, matches_table);
+    double glushkov_speed = throughput([&](std::string_view word) { return glushkov.match(word); },
+                                       words, matches_glushkov);
+
+    size_t bytes = 0;
+
+    for (const auto& word: words)
+    {
+        bytes += word.size();
+    }
+
+    std::cout << name << " (" << glushkov.size() << " positions, " << words.size() << " words averaging "
+              << static_cast<double>(bytes) / words.size() << " bytes):\n"
+              << "  throughput: " << table_speed << " MB/s table, " << glushkov_speed << " MB/s bit-parallel\n"
+              << "  matches:    " << matches_table << " table, " << matches_glushkov << " bit-parallel\n";
+}
+
+/** The keyword and near misses of it, half and half: one letter changed,
+ * added or dropped.
+ */
+std::vector<std::string> make_near_misses(const std::string& keyword, size_t count)
+{
+    static constexpr std::string_view letters = "abcdefghijklmnopqrstuvwxyz";
+
+    std::mt19937 generator{42};
+    std::uniform_int_distribution<size_t> letter{0, letters.size() - 1};
+    std::vector<std::string> words(count, keyword);
+
+    for (size_t i = 1; i < count; i += 2)
+    {
+        auto& word = words[i];
+        size_t position = generator() % word.size();
+
+        switch (generator() % 3)
+        {
+            case 0:
+            {
+                char replacement = letters[letter(generator)];
+                word[position] = replacement == word[position] ? 'x' : replacement;
+                break;
+            }
+            case 1:
+                word.insert(word.begin() + position, letters[letter(generator)]);
+                break;
+            default:
+                word.erase(position, 1);
+                break;
+        }
+    }
+
+    return words;
+}
+
+int main()
+{
+    report("for", make_for_automaton(), "for", make_near_misses("for", 1 << 20));
+
+    for (size_t length: {8, 64})
+    {
+        auto words = make_words(1 << 20 >> (length / 8), length);
+        auto numbers = make_words(1 << 20 >> (length / 8), length, digit_symbols);
+
+        report("identifier", make_identifier_automaton(), "[a-z][a-z0-9]*", words);
+        report("integer", make_integer_automaton(), "[1-9][0-9]*|0", numbers);
+    }
+
+    return EXIT_SUCCESS;
+}
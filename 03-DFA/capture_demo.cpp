@@ -0,0 +1,57 @@
+#include <iostream>
+#include <string_view>
+
+#include <TaggedDFA.hpp>
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        std::cout << "Usage: " << argv[0] << " regex word...\n";
+        return EXIT_FAILURE;
+    }
+
+    auto dfa = TaggedDFA::compile(argv[1]);
+
+    if (!dfa)
+    {
+        std::cout << "Malformed regular expression " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << dfa->num_states() << " states, " << dfa->num_registers() << " registers\n";
+
+    // The same captures serve every match.
+    TaggedDFA::Captures captures;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string_view word{argv[i]};
+
+        if (!dfa->match(word, captures))
+        {
+            std::cout << word << " does not match\n";
+            continue;
+        }
+
+        std::cout << word << " matches\n";
+
+        for (size_t group = 1; group <= dfa->num_groups(); ++group)
+        {
+            std::cout << "  " << group << ": ";
+
+            if (captures.matched(group))
+            {
+                std::cout << word.substr(captures.start(group), captures.end(group) - captures.start(group));
+            }
+            else
+            {
+                std::cout << "(none)";
+            }
+
+            std::cout << "\n";
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
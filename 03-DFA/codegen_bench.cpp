@@ -0,0 +1,32 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Benchmark.hpp>
+#include <generated_matchers.hpp>
+
+template <typename Generated>
+void report(const std::string& name, const fa_type& fa, Generated generated,
+            const std::vector<std::string>& words)
+{
+    auto table = fa.minimize().compile();
+    size_t matches_table, matches_generated;
+    double table_throughput = throughput([&](std::string_view word) { return table.match(word); },
+                                         words, matches_table);
+    double generated_throughput = throughput(generated, words, matches_generated);
+
+    std::cout << name << ":\n"
+              << "  table-driven: " << table_throughput << " MB/s, " << matches_table << " matches\n"
+              << "  direct-coded: " << generated_throughput << " MB/s, " << matches_generated << " matches\n";
+}
+
+int main()
+{
+    auto words = make_words(100000, 16);
+    auto numbers = make_words(100000, 16, digit_symbols);
+
+    report("identifier", make_identifier_automaton(), match_identifier, words);
+    report("integer", make_integer_automaton(), match_integer, numbers);
+
+    return EXIT_SUCCESS;
+}
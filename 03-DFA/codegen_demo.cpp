@@ -0,0 +1,27 @@
+#include <fstream>
+#include <iostream>
+
+#include <Benchmark.hpp>
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cout << "Usage: " << argv[0] << " output_file\n";
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream out{argv[1]};
+
+    out << "#pragma once\n\n"
+        << "#include <string_view>\n\n"
+        << "// Generated by codegen_demo, do not edit.\n\n";
+
+    make_for_automaton().to_cpp(out, "match_for");
+    out << "\n";
+    make_identifier_automaton().to_cpp(out, "match_identifier");
+    out << "\n";
+    make_integer_automaton().to_cpp(out, "match_integer");
+
+    return EXIT_SUCCESS;
+}
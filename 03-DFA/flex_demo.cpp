@@ -0,0 +1,44 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <FlexSpec.hpp>
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cout << "Usage: " << argv[0] << " scanner.flex input_file\n";
+        return EXIT_FAILURE;
+    }
+
+    std::string error;
+    auto spec = FlexSpec::load_file(argv[1], &error);
+
+    if (!spec)
+    {
+        std::cout << "Could not load " << argv[1] << ": " << error << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream in{argv[2]};
+
+    if (!in)
+    {
+        std::cout << "Could not open " << argv[2] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::stringstream content;
+    content << in.rdbuf();
+    std::string buffer = content.str();
+
+    for (const auto& token: spec->tokenize(buffer))
+    {
+        std::cout << "Token: " << spec->name(token.rule)
+                  << " value: " << buffer.substr(token.offset, token.length) << "\n";
+    }
+
+    return EXIT_SUCCESS;
+}
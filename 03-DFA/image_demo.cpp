@@ -0,0 +1,67 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Benchmark.hpp>
+#include <DFAImage.hpp>
+#include <Tokenizer.hpp>
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cout << "Usage: " << argv[0] << " word\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> dfa_names{"for", "identifier", "integer"};
+    std::vector<fa_type::compiled_type> compiled{
+        make_for_automaton().compile(),
+        make_identifier_automaton().compile(),
+        make_integer_automaton().compile()
+    };
+
+    // Save many copies of the union, as a service with many automata would.
+    constexpr size_t images = 200;
+    auto all = minimize(unite(compiled));
+
+    for (size_t i = 0; i < images; ++i)
+    {
+        if (!save_image(all, "demo" + std::to_string(i) + ".dfa"))
+        {
+            std::cout << "Could not write the images\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<MappedDFA> mapped(images);
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < images; ++i)
+    {
+        if (!mapped[i].open("demo" + std::to_string(i) + ".dfa"))
+        {
+            std::cout << "Could not load image " << i << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Loaded " << images << " automata in " << elapsed.count() << " us\n";
+
+    auto rule = mapped.back().classify(argv[1]);
+
+    if (rule != MappedDFA::no_rule)
+    {
+        std::cout << argv[1] << " matches with " << dfa_names[rule] << std::endl;
+    }
+    else
+    {
+        std::cout << "Not match found for " << argv[1] << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,48 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <AhoCorasick.hpp>
+
+void report(const std::string& name, AhoCorasick& automaton, const std::vector<std::string>& keywords,
+            std::string_view text)
+{
+    std::cout << name << " (" << automaton.automaton().num_states() << " states):\n";
+
+    for (const auto& match: automaton.find_all(text))
+    {
+        std::cout << "  " << keywords[match.keyword] << " at " << match.offset << "\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cout << "Usage: " << argv[0] << " text\n";
+        return EXIT_FAILURE;
+    }
+
+    // Keywords of 04-FlexExamples/BasicSQL, in any case
+    std::vector<std::string> sql{"select", "from", "where"};
+    AhoCorasick sql_automaton{true};
+
+    for (const auto& keyword: sql)
+    {
+        sql_automaton.add(keyword);
+    }
+
+    // Keywords of 04-FlexExamples/SMLIfExpression
+    std::vector<std::string> sml{"if", "then", "else", "andalso", "orelse"};
+    AhoCorasick sml_automaton;
+
+    for (const auto& keyword: sml)
+    {
+        sml_automaton.add(keyword);
+    }
+
+    report("SQL", sql_automaton, sql, argv[1]);
+    report("SML", sml_automaton, sml, argv[1]);
+
+    return EXIT_SUCCESS;
+}
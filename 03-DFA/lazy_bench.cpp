@@ -0,0 +1,75 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <LazyDFA.hpp>
+
+/** (a|b)*a(a|b)...(a|b) has a minimal DFA with 2^(n+1) states. */
+std::string make_pattern(size_t n)
+{
+    std::string pattern{"(a|b)*a"};
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        pattern += "(a|b)";
+    }
+
+    return pattern;
+}
+
+std::string make_text(size_t length)
+{
+    std::mt19937 generator{42};
+    std::string text(length, 'a');
+
+    for (auto& c: text)
+    {
+        c = "ab"[generator() % 2];
+    }
+
+    return text;
+}
+
+template <typename Matcher>
+void report(const std::string& name, Matcher match, const std::string& text)
+{
+    auto start = std::chrono::steady_clock::now();
+    bool matched = match(text);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "  " << name << ": " << text.size() / elapsed.count() / (1 << 20) << " MB/s"
+              << (matched ? ", match\n" : ", no match\n");
+}
+
+int main()
+{
+    auto text = make_text(1 << 22);
+
+    for (size_t n: {8, 14, 24})
+    {
+        NFA nfa{*Regex::parse(make_pattern(n))};
+        std::cout << "n = " << n << " (" << (size_t{2} << n) << " DFA states):\n";
+
+        if (n < 16)
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto dfa = nfa.to_dfa();
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+            std::cout << "  subset construction: " << elapsed.count() << " ms\n";
+            report("eager", [&](std::string_view word) { return dfa.match(word); }, text);
+        }
+
+        for (size_t budget: {size_t{64} << 20, LazyDFA::default_budget, size_t{16} << 10})
+        {
+            LazyDFA lazy{nfa, budget};
+            report("lazy, " + std::to_string(budget >> 10) + " KB",
+                   [&](std::string_view word) { return lazy.match(word); }, text);
+            std::cout << "    states: " << lazy.num_states() << ", memory: " << lazy.memory()
+                      << " bytes, flushes: " << lazy.flushes() << ", fallbacks: " << lazy.fallbacks() << "\n";
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
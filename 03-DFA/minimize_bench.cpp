@@ -0,0 +1,36 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Benchmark.hpp>
+
+void report(const std::string& name, const fa_type& fa, const std::vector<std::string>& words)
+{
+    auto compiled = fa.compile();
+    auto minimal = fa.minimize().compile();
+    size_t matches_before, matches_after;
+    double before = throughput([&](std::string_view word) { return compiled.match(word); },
+                               words, matches_before);
+    double after = throughput([&](std::string_view word) { return minimal.match(word); },
+                              words, matches_after);
+
+    std::cout << name << ":\n"
+              << "  states:     " << compiled.num_states() << " -> " << minimal.num_states() << "\n"
+              << "  table size: " << compiled.table_size() << " -> " << minimal.table_size() << " bytes\n"
+              << "  throughput: " << before << " -> " << after << " MB/s\n"
+              << "  matches:    " << matches_before << " -> " << matches_after << "\n";
+}
+
+int main()
+{
+    auto identifier = make_identifier_automaton();
+    auto integer = make_integer_automaton();
+
+    auto words = make_words(100000, 16);
+    auto numbers = make_words(100000, 16, digit_symbols);
+
+    report("identifier", identifier, words);
+    report("integer", integer, numbers);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,45 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+
+#include <ParallelMatch.hpp>
+#include <RegexCompiler.hpp>
+
+int main(int argc, char* argv[])
+{
+    size_t megabytes = argc > 1 ? std::stoul(argv[1]) : 256;
+
+    // Words separated by single spaces: no state loops on a long run here.
+    RegexCompiler compiler;
+    auto dfa = compiler.compile("([a-z][0-9]?)+( ([a-z][0-9]?)+)*")->compile();
+
+    std::mt19937 generator{42};
+    std::string text(megabytes << 20, 'a');
+
+    for (size_t i = 1; i < text.size(); ++i)
+    {
+        auto r = generator() % 8;
+        bool after_letter = text[i - 1] >= 'a' && text[i - 1] <= 'z';
+        text[i] = r == 0 && text[i - 1] != ' ' ? ' ' : r == 1 && after_letter ? char('0' + r) : char('a' + r);
+    }
+
+    text.back() = 'z';
+
+    unsigned cores = std::thread::hardware_concurrency();
+
+    for (unsigned threads = 1; threads <= std::max(1u, cores); threads *= 2)
+    {
+        ParallelMatcher matcher{dfa, threads};
+
+        auto start = std::chrono::steady_clock::now();
+        bool result = matcher.match(text);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << threads << " threads: " << text.size() / elapsed.count() / (1 << 20)
+                  << " MB/s, match = " << result << "\n";
+    }
+
+    return EXIT_SUCCESS;
+}
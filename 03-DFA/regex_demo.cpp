@@ -0,0 +1,42 @@
+#include <fstream>
+#include <iostream>
+
+#include <RegexCompiler.hpp>
+
+int main(int argc, char* argv[])
+{
+    bool utf8 = argc == 4 && std::string_view{argv[1]} == "-u";
+
+    if (argc != 3 && !utf8)
+    {
+        std::cout << "Usage: " << argv[0] << " [-u] regex word\n";
+        return EXIT_FAILURE;
+    }
+
+    // With -u the regex and the word are UTF-8.
+    argv += utf8;
+
+    RegexCompiler compiler;
+    auto dfa = compiler.compile(argv[1], utf8 ? Regex::Encoding::Utf8 : Regex::Encoding::Bytes);
+
+    if (dfa == nullptr)
+    {
+        std::cout << "Malformed regular expression " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream out{"regex.dot"};
+    dfa->to_dot(out);
+    out.close();
+
+    if (dfa->match(argv[2]))
+    {
+        std::cout << argv[2] << " matches with " << argv[1] << std::endl;
+    }
+    else
+    {
+        std::cout << argv[2] << " does not match with " << argv[1] << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
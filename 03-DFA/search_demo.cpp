@@ -0,0 +1,44 @@
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include <RegexCompiler.hpp>
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cout << "Usage: " << argv[0] << " regex file\n";
+        return EXIT_FAILURE;
+    }
+
+    RegexCompiler compiler;
+    auto dfa = compiler.compile(argv[1]);
+
+    if (dfa == nullptr)
+    {
+        std::cout << "Malformed regular expression " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream in{argv[2], std::ios::binary};
+
+    if (!in)
+    {
+        std::cout << "Could not open " << argv[2] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::string text{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+
+    auto compiled = dfa->compile();
+    Searcher<char, std::hash<char>> searcher{compiled};
+
+    for (const auto& match: searcher.find_all(text))
+    {
+        std::cout << match.offset << ":" << match.length << ": " << text.substr(match.offset, match.length) << "\n";
+    }
+
+    return EXIT_SUCCESS;
+}
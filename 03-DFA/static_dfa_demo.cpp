@@ -0,0 +1,44 @@
+#include <iostream>
+#include <string_view>
+
+#include <DemoAutomata.hpp>
+#include <StaticDFA.hpp>
+
+// The automata of DFA_demo, built at compile time.
+constexpr auto for_dfa = make_for_automaton<StaticDFA<4>>();
+constexpr auto identifier_dfa = make_identifier_automaton<StaticDFA<3>>();
+constexpr auto integer_dfa = make_integer_automaton<StaticDFA<4>>();
+
+static_assert(for_dfa.match("for") && !for_dfa.match("fo"));
+static_assert(identifier_dfa.match("abc1") && !identifier_dfa.match("1abc"));
+static_assert(integer_dfa.match("120") && integer_dfa.match("0") && !integer_dfa.match("01"));
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cout << "Usage: " << argv[0] << " word\n";
+        return EXIT_FAILURE;
+    }
+
+    std::string_view word{argv[1]};
+
+    if (for_dfa.match(word))
+    {
+        std::cout << word << " matches with for" << std::endl;
+    }
+    else if (identifier_dfa.match(word))
+    {
+        std::cout << word << " matches with identifier" << std::endl;
+    }
+    else if (integer_dfa.match(word))
+    {
+        std::cout << word << " matches with integer" << std::endl;
+    }
+    else
+    {
+        std::cout << "Not match found for " << word << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
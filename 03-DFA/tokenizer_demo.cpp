@@ -0,0 +1,55 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <RegexCompiler.hpp>
+#include <Tokenizer.hpp>
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cout << "Usage: " << argv[0] << " input_file\n";
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream in{argv[1]};
+
+    if (!in)
+    {
+        std::cout << "Could not open " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::stringstream content;
+    content << in.rdbuf();
+    std::string buffer = content.str();
+
+    std::vector<std::string> names{"for", "identifier", "integer", "space"};
+    std::vector<std::string> patterns{"for", "[a-z][a-z0-9]*", "[1-9][0-9]*|0", "[ \\t\\n]+"};
+
+    RegexCompiler compiler;
+    std::vector<DFA<char>> automata;
+
+    for (const auto& pattern: patterns)
+    {
+        automata.push_back(*compiler.compile(pattern));
+    }
+
+    Tokenizer<char> tokenizer{automata};
+
+    for (const auto& token: tokenizer.tokenize(buffer))
+    {
+        if (token.rule == 3)
+        {
+            continue;
+        }
+
+        std::cout << "Token: " << (token.rule == Tokenizer<char>::no_rule ? "UNKNOWN" : names[token.rule])
+                  << " value: " << buffer.substr(token.offset, token.length) << "\n";
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <stddef.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+    ASCII character classes, the same whatever the locale. Bytes past
+    0x7f and the NUL sentinel belong to no class.
+
+    The skip functions return the first character at or after p that is
+    not in their class. They compare 32 bytes at a time with AVX2, 16 with
+    SSE2, and one at a time otherwise, so they may read up to 31 bytes
+    past the sentinel: the source buffer is padded for that.
+*/
+
+#define CHAR_SPACE      1
+#define CHAR_DIGIT      2
+#define CHAR_ALPHA      4
+#define CHAR_UNDERSCORE 8
+
+#define S CHAR_SPACE
+#define D CHAR_DIGIT
+#define A CHAR_ALPHA
+#define U CHAR_UNDERSCORE
+
+const unsigned char char_classes[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, S, S, S, S, S, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    S, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    D, D, D, D, D, D, D, D, D, D, 0, 0, 0, 0, 0, 0,
+    0, A, A, A, A, A, A, A, A, A, A, A, A, A, A, A,
+    A, A, A, A, A, A, A, A, A, A, A, 0, 0, 0, 0, U,
+    0, A, A, A, A, A, A, A, A, A, A, A, A, A, A, A,
+    A, A, A, A, A, A, A, A, A, A, A, 0, 0, 0, 0, 0
+};
+
+#undef S
+#undef D
+#undef A
+#undef U
+
+#define is_space(c)           (char_classes[(unsigned char)(c)] & CHAR_SPACE)
+#define is_digit(c)           (char_classes[(unsigned char)(c)] & CHAR_DIGIT)
+#define is_alpha(c)           (char_classes[(unsigned char)(c)] & CHAR_ALPHA)
+#define is_alnum(c)           (char_classes[(unsigned char)(c)] & (CHAR_ALPHA | CHAR_DIGIT))
+#define is_identifier_char(c) (char_classes[(unsigned char)(c)] & (CHAR_ALPHA | CHAR_DIGIT | CHAR_UNDERSCORE))
+
+#if defined(__AVX2__)
+
+typedef __m256i chunk_t;
+
+#define CHUNK_LENGTH 32
+#define load_chunk(p)        _mm256_loadu_si256((const __m256i*)(p))
+#define set_chunk(c)         _mm256_set1_epi8((char)(c))
+#define or_chunks(a, b)      _mm256_or_si256(a, b)
+#define equal_chunks(a, b)   _mm256_cmpeq_epi8(a, b)
+#define min_chunks(a, b)     _mm256_min_epu8(a, b)
+#define sub_chunks(a, b)     _mm256_sub_epi8(a, b)
+#define chunk_mask(a)        ((unsigned)_mm256_movemask_epi8(a))
+#define FULL_MASK            0xffffffffu
+
+#elif defined(__SSE2__)
+
+typedef __m128i chunk_t;
+
+#define CHUNK_LENGTH 16
+#define load_chunk(p)        _mm_loadu_si128((const __m128i*)(p))
+#define set_chunk(c)         _mm_set1_epi8((char)(c))
+#define or_chunks(a, b)      _mm_or_si128(a, b)
+#define equal_chunks(a, b)   _mm_cmpeq_epi8(a, b)
+#define min_chunks(a, b)     _mm_min_epu8(a, b)
+#define sub_chunks(a, b)     _mm_sub_epi8(a, b)
+#define chunk_mask(a)        ((unsigned)_mm_movemask_epi8(a))
+#define FULL_MASK            0xffffu
+
+#endif
+
+#ifdef CHUNK_LENGTH
+
+/* Bytes of the chunk between low and high, as 0xff. */
+chunk_t chunk_in_range(chunk_t c, unsigned char low, unsigned char high)
+{
+    chunk_t offset = sub_chunks(c, set_chunk(low));
+    return equal_chunks(min_chunks(offset, set_chunk(high - low)), offset);
+}
+
+chunk_t space_chunk(chunk_t c)
+{
+    return or_chunks(equal_chunks(c, set_chunk(' ')), chunk_in_range(c, '\t', '\r'));
+}
+
+chunk_t digit_chunk(chunk_t c)
+{
+    return chunk_in_range(c, '0', '9');
+}
+
+chunk_t identifier_chunk(chunk_t c)
+{
+    // Setting bit 5 lowers the letters and keeps the digits and '_' apart.
+    chunk_t letters = chunk_in_range(or_chunks(c, set_chunk(0x20)), 'a', 'z');
+    return or_chunks(or_chunks(letters, digit_chunk(c)), equal_chunks(c, set_chunk('_')));
+}
+
+/* Most runs are short, so the first bytes are checked one at a time. */
+#define SCALAR_PREFIX_LENGTH 8
+
+#define SKIP_CHUNKS(p, in_class, classify)                      \
+    for (int i = 0; i < SCALAR_PREFIX_LENGTH; ++i, ++p)         \
+    {                                                           \
+        if (!in_class(*p))                                      \
+        {                                                       \
+            return p;                                           \
+        }                                                       \
+    }                                                           \
+                                                                \
+    for (;;)                                                    \
+    {                                                           \
+        unsigned mask = chunk_mask(classify(load_chunk(p)));    \
+                                                                \
+        if (mask != FULL_MASK)                                  \
+        {                                                       \
+            return p + __builtin_ctz(~mask);                    \
+        }                                                       \
+                                                                \
+        p += CHUNK_LENGTH;                                      \
+    }
+
+const char* skip_spaces(const char* p)
+{
+    SKIP_CHUNKS(p, is_space, space_chunk)
+}
+
+const char* skip_digits(const char* p)
+{
+    SKIP_CHUNKS(p, is_digit, digit_chunk)
+}
+
+const char* skip_identifier_chars(const char* p)
+{
+    SKIP_CHUNKS(p, is_identifier_char, identifier_chunk)
+}
+
+#else
+
+const char* skip_spaces(const char* p)
+{
+    while (is_space(*p))
+    {
+        ++p;
+    }
+
+    return p;
+}
+
+const char* skip_digits(const char* p)
+{
+    while (is_digit(*p))
+    {
+        ++p;
+    }
+
+    return p;
+}
+
+const char* skip_identifier_chars(const char* p)
+{
+    while (is_identifier_char(*p))
+    {
+        ++p;
+    }
+
+    return p;
+}
+
+#endif
@@ -8,15 +8,27 @@ int main(int argc, char* argv[])
         return 1;
     }
 
-    FILE* in = fopen(argv[1], "r");
+    SourceBuffer buffer;
 
-    if (!in)
+    if (!open_source_buffer(&buffer, argv[1]))
     {
         printf("Could not open %s\n", argv[1]);
         return 1;
     }
 
-    if (parse_p(in))
+    TokenStream tokens;
+
+    if (!scan_all(&buffer, &tokens))
+    {
+        printf("Out of memory\n");
+        close_source_buffer(&buffer);
+        return 1;
+    }
+
+    TokenCursor c;
+    init_token_cursor(&c, &tokens);
+
+    if (parse_p(&c))
     {
         printf("Parse successful\n");
     }
@@ -25,5 +37,8 @@ int main(int argc, char* argv[])
         printf("Parse failed\n");
     }
 
+    free_token_stream(&tokens);
+    close_source_buffer(&buffer);
+
     return 0;
 }
\ No newline at end of file
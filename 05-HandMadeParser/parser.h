@@ -15,69 +15,98 @@
 
 #pragma once
 
-#include "scanner.h"
+#include "token_stream.h"
 
-BOOL parse_p(FILE*);
-BOOL parse_e(FILE*);
-BOOL parse_e_prime(FILE*);
-BOOL parse_t(FILE*);
-BOOL parse_t_prime(FILE*);
-BOOL parse_f(FILE*);
-
-BOOL parse_p(FILE* f)
+/*
+    Position of the parser in the token stream. The input is tokenized
+    before parsing, so looking ahead is an array access and nothing has
+    to be put back.
+*/
+typedef struct
 {
-    return parse_e(f) && expect_token(f, TOKEN_EOF);
+    const TokenStream* tokens;
+    size_t             position;
 }
+TokenCursor;
 
-BOOL parse_e(FILE* f)
+void init_token_cursor(TokenCursor* c, const TokenStream* tokens)
 {
-    return parse_t(f) && parse_e_prime(f);
+    c->tokens = tokens;
+    c->position = 0;
 }
 
-BOOL parse_e_prime(FILE* f)
+/* Kind of the token distance tokens ahead, EOF past the end. */
+token_t peek_token(const TokenCursor* c, size_t distance)
 {
-    Token t = scan_token(f);
+    size_t i = c->position + distance;
+    return i < c->tokens->size ? (token_t)c->tokens->kinds[i] : TOKEN_EOF;
+}
 
-    if (t.token == TOKEN_PLUS)
+/* Moves past the next token if it is of the expected kind. */
+BOOL expect_token(TokenCursor* c, token_t expected_token_type)
+{
+    if (peek_token(c, 0) == expected_token_type)
     {
-        return parse_t(f) && parse_e_prime(f);
+        ++c->position;
+        return TRUE;
     }
 
-    put_token_back(f, t);
-    return TRUE;
+    return FALSE;
 }
 
-BOOL parse_t(FILE* f)
+BOOL parse_p(TokenCursor*);
+BOOL parse_e(TokenCursor*);
+BOOL parse_e_prime(TokenCursor*);
+BOOL parse_t(TokenCursor*);
+BOOL parse_t_prime(TokenCursor*);
+BOOL parse_f(TokenCursor*);
+
+BOOL parse_p(TokenCursor* c)
 {
-    return parse_f(f) && parse_t_prime(f);
+    return parse_e(c) && expect_token(c, TOKEN_EOF);
 }
 
-BOOL parse_t_prime(FILE* f)
+BOOL parse_e(TokenCursor* c)
 {
-    Token t = scan_token(f);
+    return parse_t(c) && parse_e_prime(c);
+}
 
-    if (t.token == TOKEN_MULTIPLY)
+BOOL parse_e_prime(TokenCursor* c)
+{
+    if (expect_token(c, TOKEN_PLUS))
     {
-        return parse_f(f) && parse_t_prime(f);
+        return parse_t(c) && parse_e_prime(c);
     }
 
-    put_token_back(f, t);
     return TRUE;
 }
 
-BOOL parse_f(FILE* f)
+BOOL parse_t(TokenCursor* c)
 {
-    Token t = scan_token(f);
+    return parse_f(c) && parse_t_prime(c);
+}
+
+BOOL parse_t_prime(TokenCursor* c)
+{
+    if (expect_token(c, TOKEN_MULTIPLY))
+    {
+        return parse_f(c) && parse_t_prime(c);
+    }
 
-    if (t.token == TOKEN_LPAREN)
+    return TRUE;
+}
+
+BOOL parse_f(TokenCursor* c)
+{
+    if (expect_token(c, TOKEN_LPAREN))
     {
-        return parse_e(f) && expect_token(f, TOKEN_RPAREN);
+        return parse_e(c) && expect_token(c, TOKEN_RPAREN);
     }
-    else if (t.token == TOKEN_INT)
+    else if (expect_token(c, TOKEN_INT))
     {
         return TRUE;
     }
 
-    printf("Parse error: unexpected token %s\n", to_str(t.token));
+    printf("Parse error: unexpected token %s\n", to_str(peek_token(c, 0)));
     return FALSE;
-}
\ No newline at end of file
+}
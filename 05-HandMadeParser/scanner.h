@@ -5,145 +5,119 @@
 
 #pragma once
 
-#include <ctype.h>
 #include <stdio.h>
+#include <string.h>
 
+#include "char_class.h"
+#include "source_buffer.h"
 #include "token.h"
 
-#ifndef BOOL
-#define BOOL int
-#endif
+/*
+    The scanner walks the source buffer with a raw pointer. The buffer
+    ends with a NUL sentinel that no character class includes, so every
+    loop stops at the end on its own.
+*/
+typedef struct
+{
+    const char* begin;
+    const char* current;
+}
+Scanner;
 
-#ifndef TRUE
-#define TRUE 1
-#endif
+void init_scanner(Scanner* s, const SourceBuffer* buffer)
+{
+    s->begin = buffer->data;
+    s->current = buffer->data;
+}
 
-#ifndef FALSE
-#define FALSE 0
-#endif
+/* Text of a token, which is not NUL-terminated: it is followed by the rest of the input. */
+const char* token_text(const Scanner* s, Token t)
+{
+    return s->begin + t.offset;
+}
 
-void skip_whitespaces(FILE* f)
+/* NUL-terminated copy of the text of a token, to be freed by the caller. */
+char* token_value(const Scanner* s, Token t)
 {
-    char c = fgetc(f);
-    
-    while (isspace(c))
+    char* value = malloc(t.length + 1);
+
+    if (value != NULL)
     {
-        c = fgetc(f);
+        memcpy(value, token_text(s, t), t.length);
+        value[t.length] = '\0';
     }
 
-    ungetc(c, f);
+    return value;
+}
+
+/* Token from begin to the current position. */
+Token scanned_token(const Scanner* s, token_t token, const char* begin)
+{
+    return make_token(token, (uint32_t)(begin - s->begin), (uint32_t)(s->current - begin));
 }
 
-BOOL is_next_equal_char(FILE* f)
+void skip_whitespaces(Scanner* s)
 {
-    char c = fgetc(f);
+    s->current = skip_spaces(s->current);
+}
 
-    if (c == '=')
+BOOL is_next_equal_char(Scanner* s)
+{
+    if (*s->current == '=')
     {
+        ++s->current;
         return TRUE;
     }
 
-    ungetc(c, f);
-
     return FALSE;
 }
 
-Token build_integer_token(FILE* f, char c)
+Token build_integer_token(Scanner* s)
 {
-    Token t = make_token();
-    t.token = TOKEN_INT;
-    t.value[t.size++] = c;
-
-    c = fgetc(f);
-
-    while (isdigit(c))
-    {
-        t.value[t.size++] = c;
-        c = fgetc(f);        
-    }
-
-    t.value[t.size++] = '\0';
-    ungetc(c, f);
+    const char* begin = s->current;
+    s->current = skip_digits(begin + 1);
 
-    return t;
+    return scanned_token(s, TOKEN_INT, begin);
 }
 
-Token scan_token(FILE* f)
+Token scan_token(Scanner* s)
 {
-    Token result = make_token();
+    skip_whitespaces(s);
 
-    skip_whitespaces(f);
+    const char* begin = s->current;
+    char c = *begin;
 
-    if (feof(f))
+    if (c == '\0')
     {
-        result.value[result.size++] = '\0';
-        result.token = TOKEN_EOF;
-        return result;
+        return scanned_token(s, TOKEN_EOF, begin);
     }
 
-    char c = fgetc(f);
+    if (is_digit(c))
+    {
+        return build_integer_token(s);
+    }
+
+    ++s->current;
 
     if (c == '(')
     {
-        result.token = TOKEN_LPAREN;
-        result.value[result.size++] = '(';
-        result.value[result.size++] = '\0';
-        return result;
+        return scanned_token(s, TOKEN_LPAREN, begin);
     }
 
     if (c == ')')
     {
-        result.token = TOKEN_RPAREN;
-        result.value[result.size++] = ')';
-        result.value[result.size++] = '\0';
-        return result;
+        return scanned_token(s, TOKEN_RPAREN, begin);
     }
 
     if (c == '+')
     {
-        result.token = TOKEN_PLUS;
-        result.value[result.size++] = '+';
-        result.value[result.size++] = '\0';
-        return result;
+        return scanned_token(s, TOKEN_PLUS, begin);
     }
 
     if (c == '*')
     {
-        result.token = TOKEN_MULTIPLY;
-        result.value[result.size++] = '*';
-        result.value[result.size++] = '\0';
-        return result;
-    }
-    
-    if (isdigit(c))
-    {
-        return build_integer_token(f, c);
+        return scanned_token(s, TOKEN_MULTIPLY, begin);
     }
 
-    result.value[result.size++] = c;
-    result.value[result.size++] = '\0';
-    result.token = TOKEN_UNKNOWN;
-    return result;
-}
-
-void put_token_back(FILE* f, Token t)
-{
-    for (int i = t.size - 2; i >= 0; --i)
-    {
-        ungetc(t.value[i], f);
-    }
+    return scanned_token(s, TOKEN_UNKNOWN, begin);
 }
-
-BOOL expect_token(FILE* f, token_t expected_token_type)
-{
-    Token t = scan_token(f);
-
-    if (t.token == expected_token_type)
-    {
-        return TRUE;
-    }
-
-    put_token_back(f, t);
-
-    return FALSE;
-}
\ No newline at end of file
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef BOOL
+#define BOOL int
+#endif
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#define READ_BLOCK_LENGTH (1 << 16)
+
+/* Zeros after the input: the sentinel, then room for reading a whole SIMD chunk from it. */
+#define SOURCE_BUFFER_PADDING 64
+
+/* Tokens hold their offset and length in 32 bits. */
+#define SOURCE_BUFFER_MAX_LENGTH UINT32_MAX
+
+/*
+    The whole input of the scanner, followed by a NUL sentinel so the
+    scanner can stop at the end without checking the length. A NUL
+    inside the input also ends it.
+
+    Regular files are mapped in memory. The mapping is longer than the
+    file by the padding: the bytes past the end of the file in its last
+    page are zeros, and anonymous pages mapped right after it hold the
+    rest. Pipes and anything that cannot be mapped are read in large
+    blocks into the heap. Inputs longer than SOURCE_BUFFER_MAX_LENGTH
+    are refused.
+*/
+typedef struct
+{
+    const char* data;
+    size_t      length;
+    size_t      mapped_length;
+}
+SourceBuffer;
+
+BOOL map_source_buffer(SourceBuffer* buffer, int fd, size_t length)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t mapped_length = (length + SOURCE_BUFFER_PADDING + page - 1) / page * page;
+
+    // Reserve zeroed pages for the file and the padding, then map the file over them.
+    char* data = mmap(NULL, mapped_length, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (data == MAP_FAILED)
+    {
+        return FALSE;
+    }
+
+    if (length > 0 && mmap(data, length, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        munmap(data, mapped_length);
+        return FALSE;
+    }
+
+    madvise(data, mapped_length, MADV_SEQUENTIAL);
+
+    buffer->data = data;
+    buffer->length = length;
+    buffer->mapped_length = mapped_length;
+    return TRUE;
+}
+
+BOOL read_source_buffer(SourceBuffer* buffer, int fd)
+{
+    size_t capacity = READ_BLOCK_LENGTH;
+    size_t length = 0;
+    char* data = malloc(capacity + SOURCE_BUFFER_PADDING);
+
+    while (data != NULL)
+    {
+        ssize_t n = read(fd, data + length, capacity - length);
+
+        if (n < 0)
+        {
+            break;
+        }
+
+        if (n == 0)
+        {
+            memset(data + length, 0, SOURCE_BUFFER_PADDING);
+            buffer->data = data;
+            buffer->length = length;
+            buffer->mapped_length = 0;
+            return TRUE;
+        }
+
+        length += (size_t)n;
+
+        if (length > SOURCE_BUFFER_MAX_LENGTH)
+        {
+            break;
+        }
+
+        if (length == capacity)
+        {
+            char* grown = realloc(data, capacity * 2 + SOURCE_BUFFER_PADDING);
+
+            if (grown == NULL)
+            {
+                break;
+            }
+
+            data = grown;
+            capacity *= 2;
+        }
+    }
+
+    free(data);
+    return FALSE;
+}
+
+BOOL open_source_buffer(SourceBuffer* buffer, const char* path)
+{
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+    {
+        return FALSE;
+    }
+
+    struct stat info;
+    BOOL is_file = fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+
+    if (is_file && (uint64_t)info.st_size > SOURCE_BUFFER_MAX_LENGTH)
+    {
+        close(fd);
+        return FALSE;
+    }
+
+    BOOL result = is_file && map_source_buffer(buffer, fd, (size_t)info.st_size);
+
+    if (!result)
+    {
+        result = read_source_buffer(buffer, fd);
+    }
+
+    close(fd);
+    return result;
+}
+
+void close_source_buffer(SourceBuffer* buffer)
+{
+    if (buffer->mapped_length > 0)
+    {
+        munmap((void*)buffer->data, buffer->mapped_length);
+    }
+    else
+    {
+        free((void*)buffer->data);
+    }
+
+    buffer->data = NULL;
+    buffer->length = 0;
+    buffer->mapped_length = 0;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "scanner.h"
+
+/*
+    Every token of an input, the final EOF included, with each field in
+    its own array so that walking the tokens reads memory in order. The
+    arrays double when they fill up.
+*/
+typedef struct
+{
+    uint8_t*  kinds;
+    uint32_t* offsets;
+    uint32_t* lengths;
+    size_t    size;
+    size_t    capacity;
+}
+TokenStream;
+
+void free_token_stream(TokenStream* stream)
+{
+    free(stream->kinds);
+    free(stream->offsets);
+    free(stream->lengths);
+
+    stream->kinds = NULL;
+    stream->offsets = NULL;
+    stream->lengths = NULL;
+    stream->size = 0;
+    stream->capacity = 0;
+}
+
+BOOL reserve_token_stream(TokenStream* stream, size_t capacity)
+{
+    uint8_t* kinds = realloc(stream->kinds, capacity * sizeof(uint8_t));
+
+    if (kinds != NULL)
+    {
+        stream->kinds = kinds;
+    }
+
+    uint32_t* offsets = realloc(stream->offsets, capacity * sizeof(uint32_t));
+
+    if (offsets != NULL)
+    {
+        stream->offsets = offsets;
+    }
+
+    uint32_t* lengths = realloc(stream->lengths, capacity * sizeof(uint32_t));
+
+    if (lengths != NULL)
+    {
+        stream->lengths = lengths;
+    }
+
+    if (kinds == NULL || offsets == NULL || lengths == NULL)
+    {
+        return FALSE;
+    }
+
+    stream->capacity = capacity;
+    return TRUE;
+}
+
+Token stream_token(const TokenStream* stream, size_t i)
+{
+    return make_token((token_t)stream->kinds[i], stream->offsets[i], stream->lengths[i]);
+}
+
+/* Tokenizes the whole buffer, returns FALSE if memory runs out. */
+BOOL scan_all(const SourceBuffer* buffer, TokenStream* stream)
+{
+    stream->kinds = NULL;
+    stream->offsets = NULL;
+    stream->lengths = NULL;
+    stream->size = 0;
+    stream->capacity = 0;
+
+    // A first guess of a token every 8 bytes avoids most of the growth.
+    if (!reserve_token_stream(stream, buffer->length / 8 + 16))
+    {
+        free_token_stream(stream);
+        return FALSE;
+    }
+
+    Scanner s;
+    init_scanner(&s, buffer);
+
+    while (TRUE)
+    {
+        if (stream->size == stream->capacity && !reserve_token_stream(stream, stream->capacity * 2))
+        {
+            free_token_stream(stream);
+            return FALSE;
+        }
+
+        Token t = scan_token(&s);
+        stream->kinds[stream->size] = (uint8_t)t.token;
+        stream->offsets[stream->size] = t.offset;
+        stream->lengths[stream->size] = t.length;
+        ++stream->size;
+
+        if (t.token == TOKEN_EOF)
+        {
+            return TRUE;
+        }
+    }
+}
@@ -23,10 +23,16 @@
         print result; // Hypotetical print statement
         return 0;
     }
+
+    and then, in the same global scope, a call with a misspelled name
+
+    acum_from_zero_to(10);
 */
 
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include <datatype.hpp>
 #include <declaration.hpp>
@@ -119,13 +125,38 @@ int main()
         }
     };
 
+    const std::string misspelled_name = "acum_from_zero_to";
+
+    auto misspelled_program = Body{
+        new ExpressionStatement{
+            new CallExpression{
+                new NameExpression{misspelled_name},
+                new ArgExpression{new IntExpression{10}, nullptr}
+            }
+        }
+    };
+
     bool resolve_name_result = false;
+    bool misspelled_resolve_name_result = false;
+    std::vector<std::string> suggestions;
     {
         SymbolTable symbol_table;
         resolve_name_result = resolve_name_body(program, symbol_table);
+        misspelled_resolve_name_result = resolve_name_body(misspelled_program, symbol_table);
+
+        if (!misspelled_resolve_name_result)
+        {
+            suggestions = symbol_table.suggest(misspelled_name);
+        }
     }
 
     std::cout << std::boolalpha << "Program name resolution: " << resolve_name_result << std::endl;
+    std::cout << std::boolalpha << "Misspelled program name resolution: " << misspelled_resolve_name_result << std::endl;
+
+    if (!suggestions.empty())
+    {
+        std::cout << "Undefined name " << misspelled_name << ", did you mean " << suggestions.front() << "?" << std::endl;
+    }
 
     auto program_copy = copy_body(program);
 
@@ -151,6 +182,7 @@ int main()
 
     destroy_body(program);
     destroy_body(program_copy);
+    destroy_body(misspelled_program);
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cstring>
+
+#include <levenshtein_automaton.hpp>
+
+LevenshteinAutomaton::LevenshteinAutomaton(std::string_view _word, unsigned _max_distance, size_t _prefix_length,
+                                           unsigned _prefix_distance) noexcept
+    : word{_word}, limit{_max_distance}, prefix_length{std::min(_prefix_length, _word.size())},
+      prefix_limit{std::min(_prefix_distance, _max_distance)}, width{_word.size() + 1}, columns(256, 0),
+      num_columns{1}, next(width + 1), slots(16, unknown), states{0}
+{
+    for (char c : this->word)
+    {
+        auto& column = this->columns[static_cast<unsigned char>(c)];
+
+        if (column == 0)
+        {
+            column = static_cast<std::uint8_t>(this->num_columns++);
+        }
+    }
+
+    for (size_t i = 0; i < this->width; ++i)
+    {
+        this->next[i] = std::min<unsigned>(i, this->limit + 1);
+    }
+
+    this->next[this->width] = this->next[this->prefix_length] <= this->prefix_limit;
+    this->add();
+}
+
+LevenshteinAutomaton::state_type LevenshteinAutomaton::initial_state() const noexcept
+{
+    return this->states == 0 ? dead_state : 0;
+}
+
+LevenshteinAutomaton::state_type LevenshteinAutomaton::delta(state_type state, char c) noexcept
+{
+    if (state == dead_state)
+    {
+        return dead_state;
+    }
+
+    size_t column = this->columns[static_cast<unsigned char>(c)];
+    size_t entry = state * this->num_columns + column;
+
+    if (this->table[entry] != unknown)
+    {
+        return this->table[entry];
+    }
+
+    // Characters not in the word never match, so any of them will do.
+    const unsigned* row = this->row(state);
+    this->next[0] = std::min(row[0] + 1, this->limit + 1);
+
+    for (size_t i = 1; i < this->width; ++i)
+    {
+        unsigned substitution = row[i - 1] + (column == 0 || this->word[i - 1] != c);
+        this->next[i] = std::min({substitution, row[i] + 1, this->next[i - 1] + 1, this->limit + 1});
+    }
+
+    this->next[this->width] = row[this->width] || this->next[this->prefix_length] <= this->prefix_limit;
+
+    state_type target = this->add();
+
+    // add() may have grown the table.
+    this->table[entry] = target;
+    return target;
+}
+
+bool LevenshteinAutomaton::is_accepting(state_type state) const noexcept
+{
+    return state != dead_state && this->row(state)[this->width - 1] <= this->limit;
+}
+
+bool LevenshteinAutomaton::can_accept(state_type state, std::uint64_t lengths) const noexcept
+{
+    return state != dead_state && (this->accepted_lengths[state] & lengths) != 0;
+}
+
+unsigned LevenshteinAutomaton::distance(state_type state) const noexcept
+{
+    return this->row(state)[this->width - 1];
+}
+
+unsigned LevenshteinAutomaton::max_distance() const noexcept
+{
+    return this->limit;
+}
+
+size_t LevenshteinAutomaton::num_states() const noexcept
+{
+    return this->states;
+}
+
+const unsigned* LevenshteinAutomaton::row(state_type state) const noexcept
+{
+    return this->cells.data() + state * (this->width + 1);
+}
+
+size_t LevenshteinAutomaton::hash(const unsigned* row) const noexcept
+{
+    size_t result = 0xcbf29ce484222325ull;
+
+    for (size_t i = 0; i <= this->width; ++i)
+    {
+        result = (result ^ row[i]) * 0x100000001b3ull;
+    }
+
+    return result;
+}
+
+LevenshteinAutomaton::state_type LevenshteinAutomaton::add() noexcept
+{
+    std::uint64_t lengths = this->suffix_lengths(this->next.data());
+
+    if (lengths == 0)
+    {
+        return dead_state;
+    }
+
+    size_t mask = this->slots.size() - 1;
+
+    for (size_t slot = this->hash(this->next.data()) & mask; ; slot = (slot + 1) & mask)
+    {
+        state_type state = this->slots[slot];
+
+        if (state == unknown)
+        {
+            state = static_cast<state_type>(this->states++);
+            this->slots[slot] = state;
+            this->cells.insert(this->cells.end(), this->next.begin(), this->next.end());
+            this->accepted_lengths.push_back(lengths);
+            this->table.resize(this->states * this->num_columns, unknown);
+
+            // Keep the table at most half full.
+            if (this->states * 2 > this->slots.size())
+            {
+                this->grow_slots();
+            }
+
+            return state;
+        }
+
+        if (std::memcmp(this->row(state), this->next.data(), this->next.size() * sizeof(unsigned)) == 0)
+        {
+            return state;
+        }
+    }
+}
+
+void LevenshteinAutomaton::grow_slots() noexcept
+{
+    this->slots.assign(this->slots.size() * 2, unknown);
+    size_t mask = this->slots.size() - 1;
+
+    for (state_type state = 0; state < this->states; ++state)
+    {
+        size_t slot = this->hash(this->row(state)) & mask;
+
+        while (this->slots[slot] != unknown)
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        this->slots[slot] = state;
+    }
+}
+
+std::uint64_t LevenshteinAutomaton::suffix_lengths(const unsigned* row) const noexcept
+{
+    // With row[i] edits spent on word[0, i), the rest of the word is matched
+    // by a suffix whose length is within the edits left of word.size() - i.
+    // Until the prefix is matched, only the entries within it can go on.
+    bool matched = row[this->width] != 0;
+    size_t end = matched ? this->width : this->prefix_length + 1;
+    unsigned bound = matched ? this->limit : this->prefix_limit;
+    std::uint64_t result = 0;
+
+    for (size_t i = 0; i < end; ++i)
+    {
+        if (row[i] > bound)
+        {
+            continue;
+        }
+
+        size_t left = this->limit - row[i];
+        size_t rest = this->word.size() - i;
+        size_t low = std::min<size_t>(rest > left ? rest - left : 0, 63);
+        size_t high = std::min<size_t>(rest + left, 63);
+
+        result |= (high == 63 ? ~std::uint64_t{0} : (std::uint64_t{2} << high) - 1) >> low << low;
+    }
+
+    return result;
+}
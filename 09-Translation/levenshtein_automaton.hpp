@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/** DFA of the strings within a given edit distance of a word.
+ *
+ * A state is a row of the edit distance table of the word against the
+ * text read so far, with distances past the maximum clipped to one more
+ * than it. Rows with every entry past the maximum lead nowhere and are
+ * the dead state. States and transitions are built the first time they
+ * are reached, and characters that do not occur in the word all share a
+ * column, so the automaton stays small whatever the alphabet. Rows are
+ * stored one after the other and interned in an open addressing table.
+ *
+ * The automaton can also require the first prefix_length characters of
+ * the word to be matched within prefix_distance edits. A state then also
+ * records whether some text read so far did so, and until one has, rows
+ * are only alive through their entries for that prefix.
+ */
+class LevenshteinAutomaton
+{
+public:
+    using state_type = std::uint32_t;
+
+    static constexpr state_type dead_state = std::numeric_limits<state_type>::max();
+
+    LevenshteinAutomaton(std::string_view _word, unsigned _max_distance, size_t _prefix_length = 0,
+                         unsigned _prefix_distance = 0) noexcept;
+
+    state_type initial_state() const noexcept;
+
+    state_type delta(state_type state, char c) noexcept;
+
+    bool is_accepting(state_type state) const noexcept;
+
+    /** Whether a suffix of r more characters can lead to an accepting
+     * state, for some r whose bit is set in lengths. Bit 63 stands for
+     * every r from 63 on.
+     */
+    bool can_accept(state_type state, std::uint64_t lengths) const noexcept;
+
+    /** Distance from the text that led to an accepting state to the word. */
+    unsigned distance(state_type state) const noexcept;
+
+    unsigned max_distance() const noexcept;
+
+    size_t num_states() const noexcept;
+
+private:
+    static constexpr state_type unknown = dead_state - 1;
+
+    // A row holds width distances and then whether the prefix was matched.
+    const unsigned* row(state_type state) const noexcept;
+
+    size_t hash(const unsigned* row) const noexcept;
+
+    /** Interns the row in next, returns its state. */
+    state_type add() noexcept;
+
+    void grow_slots() noexcept;
+
+    /** Lengths of the suffixes that can lead from the row to acceptance,
+     * zero if none can.
+     */
+    std::uint64_t suffix_lengths(const unsigned* row) const noexcept;
+
+    std::string word;
+    unsigned limit;
+    size_t prefix_length;
+    unsigned prefix_limit;
+    size_t width;
+
+    // Column of each character; column 0 is for those not in the word.
+    std::vector<std::uint8_t> columns;
+    size_t num_columns;
+
+    // Row of state q at cells[q * (width + 1)], and the row being built.
+    std::vector<unsigned> cells;
+    std::vector<unsigned> next;
+
+    // Open addressing table of states by row, unknown when empty.
+    std::vector<state_type> slots;
+
+    size_t states;
+    std::vector<state_type> table;
+
+    // Mask of suffix_lengths for each state.
+    std::vector<std::uint64_t> accepted_lengths;
+};
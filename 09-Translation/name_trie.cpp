@@ -0,0 +1,140 @@
+#include <algorithm>
+
+#include <name_trie.hpp>
+
+NameTrie::NameTrie() noexcept
+    : nodes(1) {}
+
+void NameTrie::insert(const std::string& name) noexcept
+{
+    size_t node = 0;
+    ++this->nodes[node].below;
+
+    for (size_t i = 0; i < name.size(); ++i)
+    {
+        auto& children = this->nodes[node].children;
+        auto found = std::lower_bound(children.begin(), children.end(), name[i],
+            [](const Child& child, char c) { return child.symbol < c; });
+
+        if (found == children.end() || found->symbol != name[i])
+        {
+            found = children.insert(found, Child{name[i], 0, this->nodes.size()});
+        }
+
+        found->lengths |= std::uint64_t{1} << std::min<size_t>(name.size() - i - 1, 63);
+        node = found->node;
+
+        // Emplacing may move the nodes, and with them the children.
+        if (node == this->nodes.size())
+        {
+            this->nodes.emplace_back();
+        }
+
+        ++this->nodes[node].below;
+    }
+
+    ++this->nodes[node].count;
+}
+
+bool NameTrie::erase(const std::string& name) noexcept
+{
+    if (!this->contains(name))
+    {
+        return false;
+    }
+
+    // Emptied nodes stay and are skipped by the search.
+    size_t node = 0;
+    --this->nodes[node].below;
+
+    for (char c : name)
+    {
+        node = this->child(node, c);
+        --this->nodes[node].below;
+    }
+
+    --this->nodes[node].count;
+    return true;
+}
+
+bool NameTrie::contains(const std::string& name) const noexcept
+{
+    size_t node = this->find(name);
+    return node < this->nodes.size() && this->nodes[node].count > 0;
+}
+
+std::vector<NameTrie::Suggestion> NameTrie::search(LevenshteinAutomaton& automaton) const noexcept
+{
+    std::vector<Suggestion> result;
+    std::string prefix;
+
+    if (automaton.initial_state() != LevenshteinAutomaton::dead_state)
+    {
+        this->search(0, automaton.initial_state(), automaton, prefix, result);
+    }
+
+    std::sort(result.begin(), result.end(),
+        [](const Suggestion& a, const Suggestion& b)
+        {
+            return a.second != b.second ? a.second < b.second : a.first < b.first;
+        });
+
+    return result;
+}
+
+size_t NameTrie::find(const std::string& name) const noexcept
+{
+    size_t node = 0;
+
+    for (char c : name)
+    {
+        node = this->child(node, c);
+
+        if (node == this->nodes.size())
+        {
+            return node;
+        }
+    }
+
+    return node;
+}
+
+size_t NameTrie::child(size_t node, char c) const noexcept
+{
+    const auto& children = this->nodes[node].children;
+    auto found = std::lower_bound(children.begin(), children.end(), c,
+        [](const Child& child, char symbol) { return child.symbol < symbol; });
+    return found != children.end() && found->symbol == c ? found->node : this->nodes.size();
+}
+
+void NameTrie::search(size_t node, LevenshteinAutomaton::state_type state, LevenshteinAutomaton& automaton, std::string& prefix,
+                      std::vector<Suggestion>& result) const noexcept
+{
+    if (this->nodes[node].below == 0)
+    {
+        return;
+    }
+
+    if (this->nodes[node].count > 0 && automaton.is_accepting(state))
+    {
+        result.emplace_back(prefix, automaton.distance(state));
+    }
+
+    for (const auto& child : this->nodes[node].children)
+    {
+        this->search_child(child, state, automaton, prefix, result);
+    }
+}
+
+void NameTrie::search_child(const Child& child, LevenshteinAutomaton::state_type state, LevenshteinAutomaton& automaton,
+                            std::string& prefix, std::vector<Suggestion>& result) const noexcept
+{
+    auto next = automaton.delta(state, child.symbol);
+
+    if (automaton.can_accept(next, child.lengths))
+    {
+        prefix.push_back(child.symbol);
+        this->search(child.node, next, automaton, prefix, result);
+        prefix.pop_back();
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <levenshtein_automaton.hpp>
+
+/** Multiset of names kept as a trie.
+ *
+ * Names can be added several times and are removed once per addition, so
+ * a name shadowed in an inner scope stays after the inner one goes away.
+ */
+class NameTrie
+{
+public:
+    /** Name and its edit distance to the word of the automaton. */
+    using Suggestion = std::pair<std::string, unsigned>;
+
+    NameTrie() noexcept;
+
+    void insert(const std::string& name) noexcept;
+
+    bool erase(const std::string& name) noexcept;
+
+    bool contains(const std::string& name) const noexcept;
+
+    /** Names the automaton accepts, closest first and then in order.
+     *
+     * The trie is walked along with the automaton, and a branch is left
+     * as soon as the automaton dies on it or no name below it has a
+     * length that can still end close enough to the word.
+     */
+    std::vector<Suggestion> search(LevenshteinAutomaton& automaton) const noexcept;
+
+private:
+    struct Child
+    {
+        char symbol;
+
+        // Bit r is set once a name with r more characters, or 63 for more,
+        // went through the child. Erasing leaves it set. It is kept here so
+        // that the search prunes a child without loading it.
+        std::uint64_t lengths;
+
+        size_t node;
+    };
+
+    struct Node
+    {
+        // Sorted by symbol, so that they are scanned without chasing pointers.
+        std::vector<Child> children;
+
+        // Times the name ending here was added, and names below this node.
+        size_t count = 0;
+        size_t below = 0;
+    };
+
+    size_t find(const std::string& name) const noexcept;
+
+    size_t child(size_t node, char c) const noexcept;
+
+    void search(size_t node, LevenshteinAutomaton::state_type state, LevenshteinAutomaton& automaton, std::string& prefix,
+                std::vector<Suggestion>& result) const noexcept;
+
+    void search_child(const Child& child, LevenshteinAutomaton::state_type state, LevenshteinAutomaton& automaton,
+                      std::string& prefix, std::vector<Suggestion>& result) const noexcept;
+
+    std::vector<Node> nodes;
+};
@@ -0,0 +1,84 @@
+/*
+    Times SymbolTable::suggest for a misspelled name with few and with many
+    names in scope.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <symbol_table.hpp>
+
+std::string random_name(std::mt19937& generator, size_t length)
+{
+    std::uniform_int_distribution<int> pick{'a', 'z'};
+    std::string name;
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        name.push_back(char(pick(generator)));
+    }
+
+    return name;
+}
+
+void report(size_t symbols, size_t length)
+{
+    constexpr size_t queries = 10000;
+
+    std::mt19937 generator{42};
+    std::uniform_int_distribution<size_t> pick_length{4, 12};
+    SymbolTable symbol_table;
+    std::vector<std::string> names;
+
+    while (names.size() < symbols)
+    {
+        auto name = random_name(generator, pick_length(generator));
+
+        if (symbol_table.bind(name, Symbol::build(nullptr, name)))
+        {
+            names.push_back(name);
+        }
+    }
+
+    // Misspell names of the given length by changing their middle letter.
+    std::vector<std::string> misspelled;
+
+    for (const auto& name: names)
+    {
+        if (name.size() == length)
+        {
+            misspelled.push_back(name);
+            char& c = misspelled.back()[length / 2];
+            c = c == 'z' ? 'a' : c + 1;
+        }
+    }
+
+    size_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < queries; ++i)
+    {
+        found += !symbol_table.suggest(misspelled[i % misspelled.size()]).empty();
+    }
+
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << symbols << " symbols, " << length << " letters: " << elapsed.count() / queries << " us per lookup, "
+              << found << " of " << queries << " with a suggestion\n";
+}
+
+int main()
+{
+    for (size_t length: {5, 8, 10})
+    {
+        for (size_t symbols: {1000, 10000, 100000})
+        {
+            report(symbols, length);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <symbol_table.hpp>
 
 std::shared_ptr<Symbol> Symbol::build(Datatype* type, std::string_view name) noexcept
@@ -30,6 +32,12 @@ bool SymbolTable::exit_scope() noexcept
         return false;
     }
 
+    for (const auto& [name, symbol] : this->scopes.back())
+    {
+        this->names.erase(name);
+        this->reversed_names.erase(std::string{name.rbegin(), name.rend()});
+    }
+
     this->scopes.pop_back();
     return true;
 }
@@ -54,6 +62,8 @@ bool SymbolTable::bind(const std::string& name, std::shared_ptr<Symbol> symbol)
     }
 
     current_scope.emplace(name, symbol);
+    this->names.insert(name);
+    this->reversed_names.insert(std::string{name.rbegin(), name.rend()});
 
     return true;
 }
@@ -83,6 +93,48 @@ std::shared_ptr<Symbol> SymbolTable::current_scope_lookup(const std::string& nam
     return SymbolTable::find_in_scope(name, this->scopes.back());
 }
 
+std::vector<std::string> SymbolTable::suggest(const std::string& name) const noexcept
+{
+    return this->suggest(name, SymbolTable::edit_budget(name.size()));
+}
+
+std::vector<std::string> SymbolTable::suggest(const std::string& name, unsigned max_distance) const noexcept
+{
+    size_t half = name.size() / 2;
+    std::string reversed{name.rbegin(), name.rend()};
+    LevenshteinAutomaton head{name, max_distance, half, max_distance / 2};
+    LevenshteinAutomaton tail{reversed, max_distance, name.size() - half, max_distance / 2};
+
+    auto found = this->names.search(head);
+
+    for (auto& [reversed_name, distance] : this->reversed_names.search(tail))
+    {
+        found.emplace_back(std::string{reversed_name.rbegin(), reversed_name.rend()}, distance);
+    }
+
+    // Names found by both walks come out equal, distance included.
+    std::sort(found.begin(), found.end(),
+        [](const NameTrie::Suggestion& a, const NameTrie::Suggestion& b)
+        {
+            return a.second != b.second ? a.second < b.second : a.first < b.first;
+        });
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+
+    std::vector<std::string> result;
+
+    for (auto& suggestion : found)
+    {
+        result.push_back(std::move(suggestion.first));
+    }
+
+    return result;
+}
+
+unsigned SymbolTable::edit_budget(size_t length) noexcept
+{
+    return length <= 5 ? 1 : 2;
+}
+
 std::shared_ptr<Symbol> SymbolTable::find_in_scope(const std::string& name, const TableType& scope) noexcept
 {
     auto found_it = scope.find(name);
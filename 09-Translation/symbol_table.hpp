@@ -6,6 +6,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include <name_trie.hpp>
+
 class Datatype;
 
 struct Symbol
@@ -38,8 +40,25 @@ public:
 
     std::shared_ptr<Symbol> current_scope_lookup(const std::string& name) noexcept;
 
+    /** Visible names within the edit budget of name, closest first. */
+    std::vector<std::string> suggest(const std::string& name) const noexcept;
+
+    /** Visible names within max_distance edits of name, closest first.
+     *
+     * Such a name matches either the first or the second half of name
+     * within max_distance / 2 edits, so the names are searched forwards
+     * under the first condition and reversed under the second. Each walk
+     * then leaves most branches within their first characters.
+     */
+    std::vector<std::string> suggest(const std::string& name, unsigned max_distance) const noexcept;
+
+    /** Edits allowed for a suggestion: one for short names, two otherwise. */
+    static unsigned edit_budget(size_t length) noexcept;
+
 private:
     static std::shared_ptr<Symbol> find_in_scope(const std::string& name, const TableType& scope) noexcept;
 
     TableStack scopes;
+    NameTrie names;
+    NameTrie reversed_names;
 };
\ No newline at end of file